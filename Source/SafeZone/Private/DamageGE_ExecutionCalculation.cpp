@@ -3,6 +3,7 @@
 
 #include "DamageGE_ExecutionCalculation.h"
 #include "PlayerAttributeSet.h"
+#include "SafeZoneGameplayTags.h"
 
 // Declare the attributes to capture and define how we want to capture them from the Source and Target.
 struct DamageGE_Stats
@@ -55,7 +56,7 @@ void UDamageGE_ExecutionCalculation::Execute_Implementation(const FGameplayEffec
 	// Capture optional damage value set on the damage GE as a CalculationModifier under the ExecutionCalculation
 	ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(DamageStats().DamageDef, EvaluationParameters, Damage);
 	// Add SetByCaller damage if it exists
-	Damage += FMath::Max<float>(Spec.GetSetByCallerMagnitude(FGameplayTag::RequestGameplayTag(FName("Data.Damage")), false, -1.0f), 0.0f);
+	Damage += FMath::Max<float>(Spec.GetSetByCallerMagnitude(FSafeZoneGameplayTags::Get().Data_Damage, false, -1.0f), 0.0f);
 
 	if (Damage > 0.f)
 	{
@@ -2,6 +2,7 @@
 
 
 #include "DeafultGameplayAbility.h"
+#include "SafeZoneGameplayTags.h"
 
 UDeafultGameplayAbility::UDeafultGameplayAbility()
 {
@@ -9,8 +10,25 @@ UDeafultGameplayAbility::UDeafultGameplayAbility()
 
 	bActivateAbilityOnGranted = false;
 	bActivateOnInput = true;
+}
+
+void UDeafultGameplayAbility::PostInitProperties()
+{
+	Super::PostInitProperties();
 
 	//can be used to trigger the effects based on tags
-	ActivationBlockedTags.AddTag(FGameplayTag::RequestGameplayTag("State.Dead"));
-	ActivationBlockedTags.AddTag(FGameplayTag::RequestGameplayTag("State.KnockedDown"));
+	ActivationBlockedTags.AddTag(FSafeZoneGameplayTags::Get().State_Dead);
+	ActivationBlockedTags.AddTag(FSafeZoneGameplayTags::Get().State_KnockedDown);
+}
+
+UDeafultGameplayAbility_NonInstanced::UDeafultGameplayAbility_NonInstanced()
+{
+	InstancingPolicy = EGameplayAbilityInstancingPolicy::NonInstanced;
+	ReplicationPolicy = EGameplayAbilityReplicationPolicy::ReplicateNo;
+}
+
+UDeafultGameplayAbility_InstancedPerExecution::UDeafultGameplayAbility_InstancedPerExecution()
+{
+	InstancingPolicy = EGameplayAbilityInstancingPolicy::InstancedPerExecution;
+	ReplicationPolicy = EGameplayAbilityReplicationPolicy::ReplicateNo;
 }
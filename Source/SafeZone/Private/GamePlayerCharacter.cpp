@@ -1,391 +1,617 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-
-#include "GamePlayerCharacter.h"
-#include "Camera/CameraComponent.h"
-#include "Components/CapsuleComponent.h"
-#include "Components/InputComponent.h"
-#include "GameFramework/CharacterMovementComponent.h"
-#include "GameFramework/Controller.h"	
-#include "GameFramework/SpringArmComponent.h"
-#include "Net/UnrealNetwork.h"
-#include "GameFramework/PlayerState.h"
-#include "SafeZoneGameMode.h"
-#include "GamePlayerController.h"
-//Abiilty System Component
-#include "PlayerAttributeSet.h"
-#include "AbilitySystemBlueprintLibrary.h"
-
-AGamePlayerCharacter::AGamePlayerCharacter()
-{
-	// Set size for collision capsule
-	GetCapsuleComponent()->InitCapsuleSize(42.f, 96.0f);
-
-	// set our turn rates for input
-	BaseTurnRate = 45.f;
-	BaseLookUpRate = 45.f;
-
-	// Don't rotate when the controller rotates. Let that just affect the camera.
-	bUseControllerRotationPitch = false;
-	bUseControllerRotationYaw = false;
-	bUseControllerRotationRoll = false;
-
-	// Configure character movement
-	GetCharacterMovement()->bOrientRotationToMovement = true; // Character moves in the direction of input...	
-	GetCharacterMovement()->RotationRate = FRotator(0.0f, 540.0f, 0.0f); // ...at this rotation rate
-	GetCharacterMovement()->JumpZVelocity = 600.f;
-	GetCharacterMovement()->AirControl = 0.2f;
-
-	// Initialize the AbilitySystemComponent, but only on the server
-	if (GetLocalRole() == ROLE_Authority)
-	{
-		AbilitySystemComponent = CreateDefaultSubobject<UAbilitySystemComponent>(TEXT("AbilitySystemComponent"));
-	}
-
-	// Create the attribute set, this replicates by default
-	// Adding it as a subobject of the owning actor of an AbilitySystemComponent
-	// automatically registers the AttributeSet with the AbilitySystemComponent
-	PlayerAttribute = CreateDefaultSubobject<UPlayerAttributeSet>(TEXT("PlayerAttributeSet"));
-
-	bIsKnockedDown = false;
-	KnockdownHealthThreshold = 20.0f;
-
-	OutsideSafeZoneTag = FGameplayTag::RequestGameplayTag(TEXT("State.OutsideSafeZone"));
-
-	SetReplicates(true);
-	SetReplicateMovement(true);
-
-}
-
-void AGamePlayerCharacter::BeginPlay()
-{
-	Super::BeginPlay();
-
-	// Setup delegate if this is the server
-	if (GetLocalRole() == ROLE_Authority && AbilitySystemComponent)
-	{
-		AbilitySystemComponent->GetGameplayAttributeValueChangeDelegate(PlayerAttribute->GetHealthAttribute()).AddUObject(this, &AGamePlayerCharacter::HealthChanged);
-		AbilitySystemComponent->RegisterGameplayTagEvent(OutsideSafeZoneTag, EGameplayTagEventType::NewOrRemoved).AddUObject(this, &AGamePlayerCharacter::OutsideSafeZoneTagChanged);
-	}
-}
-
-void AGamePlayerCharacter::PossessedBy(AController* NewController)
-{
-
-	Super::PossessedBy(NewController);
-
-	InitializeAttributes();
-
-	AddStartupEffects();
-
-	AddCharacterAbilities();
-
-	SetHealth(GetCharacterMaxHealth());
-}
-
-void AGamePlayerCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
-{
-	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
-
-	DOREPLIFETIME(AGamePlayerCharacter, bIsKnockedDown);
-	DOREPLIFETIME(AGamePlayerCharacter, IsCharacterDead);	
-}
-
-void AGamePlayerCharacter::ApplyOutsideSafeZoneTag()
-{
-	if (IsValid(AbilitySystemComponent))
-	{
-		AbilitySystemComponent->AddLooseGameplayTag(OutsideSafeZoneTag);
-	}
-}
-
-void AGamePlayerCharacter::RemoveOutsideSafeZoneTag()
-{
-	if (IsValid(AbilitySystemComponent))
-	{
-		AbilitySystemComponent->RemoveLooseGameplayTag(OutsideSafeZoneTag);
-	}
-}
-
-
-UAbilitySystemComponent* AGamePlayerCharacter::GetAbilitySystemComponent() const
-{
-	return AbilitySystemComponent;
-}
-
-bool AGamePlayerCharacter::IsCharacterAlive()
-{
-	return GetCharacterHealth() > 0.0f;
-}
-
-void AGamePlayerCharacter::RemoveCharacterAbilities()
-{
-	if (GetLocalRole() != ROLE_Authority || !IsValid(AbilitySystemComponent) || !bCharacterAbilitiesGiven)
-	{
-		return;
-	}
-
-	// Remove any abilities added from a previous call. This checks to make sure the ability is in the startup 'CharacterAbilities' array.
-	TArray<FGameplayAbilitySpecHandle> AbilitiesToRemove;
-	for (const FGameplayAbilitySpec& Spec : AbilitySystemComponent->GetActivatableAbilities())
-	{
-		if ((Spec.SourceObject == this) && CharacterAbilities.Contains(Spec.Ability->GetClass()))
-		{
-			AbilitiesToRemove.Add(Spec.Handle);
-		}
-	}
-
-	// Do in two passes so the removal happens after we have the full list
-	for (int32 i = 0; i < AbilitiesToRemove.Num(); i++)
-	{
-		AbilitySystemComponent->ClearAbility(AbilitiesToRemove[i]);
-	}
-
-	bCharacterAbilitiesGiven = false;
-}
-
-void AGamePlayerCharacter::Die()
-{
-	if (!HasAuthority())
-	{
-		return;
-	}
-
-	// Only runs on Server
-	RemoveCharacterAbilities();
-	MulticastPlayDeathAnimation();
-	GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-	GetCharacterMovement()->GravityScale = 0;
-	GetCharacterMovement()->Velocity = FVector(0);
-
-	if (IsValid(AbilitySystemComponent))
-	{
-		// Clear the timer for applying damage
-		if (GetWorld()->GetTimerManager().IsTimerActive(DamageTimerHandle))
-		{
-			GetWorld()->GetTimerManager().ClearTimer(DamageTimerHandle);
-		}
-
-		// Remove the active gameplay effect if it exists
-		if (DamageEffectHandle.IsValid())
-		{
-			AbilitySystemComponent->RemoveActiveGameplayEffect(DamageEffectHandle);
-			DamageEffectHandle.Invalidate(); // Invalidate the handle after removing the effect
-		}
-
-		AbilitySystemComponent->CancelAllAbilities();
-		ForceNetUpdate();
-	}
-
-	// Set a timer to call FinishDying after 3 seconds
-	FTimerHandle TimerHandle;
-	GetWorld()->GetTimerManager().SetTimer(TimerHandle, this, &AGamePlayerCharacter::FinishDying, 3.0f, false);
-}
-
-
-void AGamePlayerCharacter::FinishDying()
-{
-	if (!HasAuthority())
-	{
-		return;
-	}
-	
-	ASafeZoneGameMode* GameMode = Cast<ASafeZoneGameMode>(GetWorld()->GetAuthGameMode());
-	if (GameMode)
-	{
-		GameMode->ManagePlayerCount();
-	}
-
-
-	AController* OwningController = GetController();
-	if (OwningController)
-	{
-		OwningController->UnPossess();
-	}
-
-
-	Destroy();
-}
-
-float AGamePlayerCharacter::GetCharacterHealth() const
-{
-	if (IsValid(PlayerAttribute))
-	{
-		return PlayerAttribute->GetHealth();
-	}
-
-	return 0.0f;
-}
-
-float AGamePlayerCharacter::GetCharacterMaxHealth() const
-{
-	if (IsValid(PlayerAttribute))
-	{
-		return PlayerAttribute->GetMaxHealth();
-	}
-
-	return 0.0f;
-}
-
-void AGamePlayerCharacter::MulticastPlayKnockdownAnimation_Implementation()
-{
-
-}
-
-void AGamePlayerCharacter::MulticastPlayDeathAnimation_Implementation()
-{
-	IsCharacterDead = true;
-}	
-
-void AGamePlayerCharacter::AddCharacterAbilities()
-{
-	// Grant abilities, but only on the server	
-	if (GetLocalRole() != ROLE_Authority || !IsValid(AbilitySystemComponent) || bCharacterAbilitiesGiven)
-	{
-		return;
-	}
-
-	for (TSubclassOf<UGameplayAbility>& StartupAbility : CharacterAbilities)
-	{
-		FGameplayAbilitySpecHandle DefaultHandle = AbilitySystemComponent->GiveAbility(FGameplayAbilitySpec(StartupAbility, 1, 1, this));
-		AbilitySystemComponent->TryActivateAbility(DefaultHandle);
-	}
-
-	bCharacterAbilitiesGiven = true;
-}
-
-void AGamePlayerCharacter::InitializeAttributes()
-{
-	if (!IsValid(AbilitySystemComponent))
-	{
-		return;
-	}
-
-	if (!DefaultAttributes)
-	{
-		UE_LOG(LogTemp, Error, TEXT("%s() Missing DefaultAttributes for %s. Please fill in the character's Blueprint."), *FString(__FUNCTION__), *GetName());
-		return;
-	}
-
-	// Can run on Server and Client
-	FGameplayEffectContextHandle EffectContext = AbilitySystemComponent->MakeEffectContext();
-	EffectContext.AddSourceObject(this);
-
-	FGameplayEffectSpecHandle NewHandle = AbilitySystemComponent->MakeOutgoingSpec(DefaultAttributes, 1, EffectContext);
-	if (NewHandle.IsValid())
-	{
-		FActiveGameplayEffectHandle ActiveGEHandle = AbilitySystemComponent->ApplyGameplayEffectSpecToSelf(*NewHandle.Data.Get());
-	}
-}
-
-void AGamePlayerCharacter::AddStartupEffects()
-{
-	if (GetLocalRole() != ROLE_Authority || !IsValid(AbilitySystemComponent) || bStartupEffectsApplied)
-	{
-		return;
-	}
-
-	FGameplayEffectContextHandle EffectContext = AbilitySystemComponent->MakeEffectContext();
-	EffectContext.AddSourceObject(this);
-
-	for (TSubclassOf<UGameplayEffect> GameplayEffect : StartupEffects)
-	{
-		FGameplayEffectSpecHandle NewHandle = AbilitySystemComponent->MakeOutgoingSpec(GameplayEffect, 1, EffectContext);
-		if (NewHandle.IsValid())
-		{
-			FActiveGameplayEffectHandle ActiveGEHandle = AbilitySystemComponent->ApplyGameplayEffectSpecToTarget(*NewHandle.Data.Get(), AbilitySystemComponent);
-		}
-	}
-
-	bStartupEffectsApplied = true;
-}
-
-void AGamePlayerCharacter::HealthChanged(const FOnAttributeChangeData& Data)
-{
-	if (GetLocalRole() == ROLE_Authority)
-	{
-		if (Data.NewValue <= 0.0f)
-		{
-			Die();
-		}
-		else if (Data.NewValue <= KnockdownHealthThreshold && !bIsKnockedDown)
-		{
-			Knockdown();
-		}
-	}
-}
-
-void AGamePlayerCharacter::OutsideSafeZoneTagChanged(const FGameplayTag CallbackTag, int32 NewCount)
-{
-	if (!HasAuthority())
-	{
-		return;
-	}
-
-	if (AbilitySystemComponent && IsCharacterAlive())
-	{
-		if (AbilitySystemComponent->HasMatchingGameplayTag(OutsideSafeZoneTag))
-		{
-			GetWorld()->GetTimerManager().SetTimer(
-				DamageTimerHandle,
-				[WeakThis = TWeakObjectPtr<AGamePlayerCharacter>(this)]()
-			{
-				if (WeakThis.IsValid() && WeakThis->AbilitySystemComponent)
-				{
-					FGameplayEffectSpecHandle SpecHandle = WeakThis->AbilitySystemComponent->MakeOutgoingSpec(WeakThis->DamageEffectClass, 1, WeakThis->AbilitySystemComponent->MakeEffectContext());
-					if (SpecHandle.IsValid())
-					{
-						// Set the damage magnitude
-						float DamageAmount = 5.0f; // Calculate your damage amount here
-						UAbilitySystemBlueprintLibrary::AssignTagSetByCallerMagnitude(SpecHandle, FGameplayTag::RequestGameplayTag(FName("Data.Damage")), DamageAmount);
-
-						WeakThis->DamageEffectHandle = WeakThis->AbilitySystemComponent->BP_ApplyGameplayEffectSpecToSelf(SpecHandle);
-					}
-				}
-			},
-				DamageInterval, // Your damage interval
-				true // Repeating timer
-				);
-		}
-		else if (GetWorld()->GetTimerManager().IsTimerActive(DamageTimerHandle))
-		{
-			// Tag does not exist, stop the effect and clear the timer
-			GetWorld()->GetTimerManager().ClearTimer(DamageTimerHandle);
-
-			// Stop the gameplay effect if it's active
-			if (AbilitySystemComponent && DamageEffectHandle.IsValid())
-			{
-				AbilitySystemComponent->RemoveActiveGameplayEffect(DamageEffectHandle);
-			}
-		}
-	}
-}
-
-void AGamePlayerCharacter::Knockdown()
-{
-	bIsKnockedDown = true;
-	MulticastPlayKnockdownAnimation();
-}
-
-void AGamePlayerCharacter::SetHealth(float Health)
-{
-	if (IsValid(PlayerAttribute))
-	{
-		PlayerAttribute->SetHealth(Health);
-	}
-}
-
-void AGamePlayerCharacter::OnRep_IsKnockedDown()
-{
-	//logic when knockeddown
-	//like removing weapons, abilities etc
-}
-
-FString AGamePlayerCharacter::GetPlayerUniqueNetIdAsString()
-{
-	if (GetPlayerState())
-	{
-		return GetPlayerState()->GetUniqueId().ToString();
-	}
-	return FString();
-}
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GamePlayerCharacter.h"
+#include "Animation/AnimInstance.h"
+#include "Camera/CameraComponent.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/InputComponent.h"
+#include "GameFramework/CharacterMovementComponent.h"
+#include "GameFramework/Controller.h"	
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/SpringArmComponent.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "GameFramework/PlayerState.h"
+#include "SafeZoneGameMode.h"
+#include "GamePlayerController.h"
+//Abiilty System Component
+#include "PlayerAttributeSet.h"
+#include "SafeZoneStats.h"
+#include "SafeZoneGameplayTags.h"
+
+AGamePlayerCharacter::AGamePlayerCharacter()
+{
+	// Set size for collision capsule
+	GetCapsuleComponent()->InitCapsuleSize(42.f, 96.0f);
+
+	// set our turn rates for input
+	BaseTurnRate = 45.f;
+	BaseLookUpRate = 45.f;
+
+	// Don't rotate when the controller rotates. Let that just affect the camera.
+	bUseControllerRotationPitch = false;
+	bUseControllerRotationYaw = false;
+	bUseControllerRotationRoll = false;
+
+	// Configure character movement
+	GetCharacterMovement()->bOrientRotationToMovement = true; // Character moves in the direction of input...	
+	GetCharacterMovement()->RotationRate = FRotator(0.0f, 540.0f, 0.0f); // ...at this rotation rate
+	GetCharacterMovement()->JumpZVelocity = 600.f;
+	GetCharacterMovement()->AirControl = 0.2f;
+
+	// Initialize the AbilitySystemComponent, but only on the server
+	if (GetLocalRole() == ROLE_Authority)
+	{
+		AbilitySystemComponent = CreateDefaultSubobject<UAbilitySystemComponent>(TEXT("AbilitySystemComponent"));
+		AbilitySystemComponent->SetIsReplicated(true);
+
+		// Gameplay effects replicate fully to the owning client only, simulated proxies get tags and cues
+		AbilitySystemComponent->SetReplicationMode(EGameplayEffectReplicationMode::Mixed);
+	}
+
+	// Create the attribute set, this replicates by default
+	// Adding it as a subobject of the owning actor of an AbilitySystemComponent
+	// automatically registers the AttributeSet with the AbilitySystemComponent
+	PlayerAttribute = CreateDefaultSubobject<UPlayerAttributeSet>(TEXT("PlayerAttributeSet"));
+
+	bIsKnockedDown = false;
+	KnockdownHealthThreshold = 20.0f;
+	IsCharacterDead = false;
+	DeathTime = -1.0f;
+	KnockdownTime = -1.0f;
+	PlayerHandle = INDEX_NONE;
+	ProxyHealth = MAX_uint8;
+	ProxyHealthSteps = 20;
+
+	SetReplicates(true);
+	SetReplicateMovement(true);
+
+}
+
+void AGamePlayerCharacter::PostInitProperties()
+{
+	Super::PostInitProperties();
+
+	OutsideSafeZoneTag = FSafeZoneGameplayTags::Get().State_OutsideSafeZone;
+}
+
+void AGamePlayerCharacter::BeginPlay()
+{
+	Super::BeginPlay();
+
+	// Setup delegate if this is the server
+	if (GetLocalRole() == ROLE_Authority && AbilitySystemComponent)
+	{
+		AbilitySystemComponent->GetGameplayAttributeValueChangeDelegate(PlayerAttribute->GetHealthAttribute()).AddUObject(this, &AGamePlayerCharacter::HealthChanged);
+		AbilitySystemComponent->RegisterGameplayTagEvent(OutsideSafeZoneTag, EGameplayTagEventType::NewOrRemoved).AddUObject(this, &AGamePlayerCharacter::OutsideSafeZoneTagChanged);
+	}
+}
+
+void AGamePlayerCharacter::PossessedBy(AController* NewController)
+{
+
+	Super::PossessedBy(NewController);
+
+	// During match start the game mode spreads the initialization over frames
+	ASafeZoneGameMode* GameMode = GetSafeZoneGameMode();
+	if (GameMode && GameMode->DeferCharacterInitialization(this))
+	{
+		return;
+	}
+
+	InitializeForPlay();
+}
+
+void AGamePlayerCharacter::InitializeForPlay()
+{
+	if (SpawnAttributes.Num() > 0)
+	{
+		// Pooled respawn, startup effects are still active and only the base values need resetting
+		RestoreSpawnAttributes();
+	}
+	else
+	{
+		InitializeAttributes();
+
+		AddStartupEffects();
+
+		SetHealth(GetCharacterMaxHealth());
+
+		CaptureSpawnAttributes();
+	}
+
+	AddCharacterAbilities();
+
+	if (ASafeZoneGameMode* GameMode = GetSafeZoneGameMode())
+	{
+		GameMode->RegisterPlayerCharacter(this);
+	}
+}
+
+void AGamePlayerCharacter::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
+{
+	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+	DOREPLIFETIME(AGamePlayerCharacter, bIsKnockedDown);
+	DOREPLIFETIME(AGamePlayerCharacter, IsCharacterDead);	
+	DOREPLIFETIME(AGamePlayerCharacter, DeathTime);
+	DOREPLIFETIME(AGamePlayerCharacter, KnockdownTime);
+
+	// Only changes when the character is bound to or released from a registry handle
+	FDoRepLifetimeParams HandleParams;
+	HandleParams.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AGamePlayerCharacter, PlayerHandle, HandleParams);
+
+	// The owner has the Health attribute, only changes of a whole step are marked dirty
+	FDoRepLifetimeParams ProxyHealthParams;
+	ProxyHealthParams.Condition = COND_SkipOwner;
+	ProxyHealthParams.bIsPushBased = true;
+	DOREPLIFETIME_WITH_PARAMS_FAST(AGamePlayerCharacter, ProxyHealth, ProxyHealthParams);
+}
+
+void AGamePlayerCharacter::ApplyOutsideSafeZoneTag()
+{
+	if (IsValid(AbilitySystemComponent))
+	{
+		AbilitySystemComponent->AddLooseGameplayTag(OutsideSafeZoneTag);
+	}
+}
+
+void AGamePlayerCharacter::RemoveOutsideSafeZoneTag()
+{
+	if (IsValid(AbilitySystemComponent))
+	{
+		AbilitySystemComponent->RemoveLooseGameplayTag(OutsideSafeZoneTag);
+	}
+}
+
+
+UAbilitySystemComponent* AGamePlayerCharacter::GetAbilitySystemComponent() const
+{
+	return AbilitySystemComponent;
+}
+
+bool AGamePlayerCharacter::IsCharacterAlive()
+{
+	return GetCharacterHealth() > 0.0f;
+}
+
+void AGamePlayerCharacter::RemoveCharacterAbilities()
+{
+	if (GetLocalRole() != ROLE_Authority || !IsValid(AbilitySystemComponent) || !bCharacterAbilitiesGiven)
+	{
+		return;
+	}
+
+	// Remove any abilities added from a previous call. This checks to make sure the ability is in the startup 'CharacterAbilities' array.
+	TArray<FGameplayAbilitySpecHandle> AbilitiesToRemove;
+	for (const FGameplayAbilitySpec& Spec : AbilitySystemComponent->GetActivatableAbilities())
+	{
+		if ((Spec.SourceObject == this) && CharacterAbilities.Contains(Spec.Ability->GetClass()))
+		{
+			AbilitiesToRemove.Add(Spec.Handle);
+		}
+	}
+
+	// Do in two passes so the removal happens after we have the full list
+	for (int32 i = 0; i < AbilitiesToRemove.Num(); i++)
+	{
+		AbilitySystemComponent->ClearAbility(AbilitiesToRemove[i]);
+	}
+
+	bCharacterAbilitiesGiven = false;
+}
+
+void AGamePlayerCharacter::Die()
+{
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	// Only runs on Server
+	RemoveCharacterAbilities();
+
+	// Replicated as state, clients play the montage from OnRep_IsCharacterDead
+	IsCharacterDead = true;
+	DeathTime = GetServerWorldTime();
+	OnRep_IsCharacterDead();
+
+	GetCapsuleComponent()->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+	GetCharacterMovement()->GravityScale = 0;
+	GetCharacterMovement()->Velocity = FVector(0);
+
+	// Stop taking zone damage
+	if (ASafeZoneGameMode* GameMode = GetSafeZoneGameMode())
+	{
+		GameMode->GetZoneDamageScheduler().RemovePlayer(this);
+		GameMode->SetPlayerDead(PlayerHandle);
+	}
+
+	if (IsValid(AbilitySystemComponent))
+	{
+		AbilitySystemComponent->CancelAllAbilities();
+	}
+
+	// Get the death state out before FinishDying releases the character, hidden in the pool or destroyed with bPoolPlayerCharacters off
+	ForceNetUpdate();
+
+	// Set a timer to call FinishDying after 3 seconds
+	GetWorld()->GetTimerManager().SetTimer(FinishDyingTimerHandle, this, &AGamePlayerCharacter::FinishDying, 3.0f, false);
+}
+
+
+void AGamePlayerCharacter::FinishDying()
+{
+	if (!HasAuthority())
+	{
+		return;
+	}
+	
+	ASafeZoneGameMode* GameMode = Cast<ASafeZoneGameMode>(GetWorld()->GetAuthGameMode());
+	if (GameMode)
+	{
+		GameMode->ManagePlayerCount();
+	}
+
+
+	AController* OwningController = GetController();
+	if (OwningController)
+	{
+		OwningController->UnPossess();
+	}
+
+	if (GameMode)
+	{
+		GameMode->ReleasePlayerCharacter(this);
+	}
+	else
+	{
+		Destroy();
+	}
+}
+
+void AGamePlayerCharacter::DeactivateForPool()
+{
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	if (IsValid(AbilitySystemComponent))
+	{
+		AbilitySystemComponent->SetLooseGameplayTagCount(OutsideSafeZoneTag, 0);
+	}
+
+	// Pooled before FinishDying ran, e.g. by a match reset
+	GetWorldTimerManager().ClearTimer(FinishDyingTimerHandle);
+
+	GetCharacterMovement()->StopMovementImmediately();
+	GetCharacterMovement()->DisableMovement();
+	SetActorHiddenInGame(true);
+	SetActorEnableCollision(false);
+	SetActorTickEnabled(false);
+	SetPlayerHandle(INDEX_NONE);
+
+	// The hidden state goes out with the last update before the channel goes dormant
+	SetNetDormancy(DORM_DormantAll);
+}
+
+void AGamePlayerCharacter::ActivateFromPool(const FTransform& SpawnTransform)
+{
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	const AGamePlayerCharacter* Defaults = GetClass()->GetDefaultObject<AGamePlayerCharacter>();
+
+	SetNetDormancy(DORM_Awake);
+	SetActorTransform(SpawnTransform, false, nullptr, ETeleportType::ResetPhysics);
+	SetActorHiddenInGame(false);
+	SetActorEnableCollision(true);
+	SetActorTickEnabled(true);
+	GetCapsuleComponent()->SetCollisionEnabled(Defaults->GetCapsuleComponent()->GetCollisionEnabled());
+	GetCharacterMovement()->GravityScale = Defaults->GetCharacterMovement()->GravityScale;
+	GetCharacterMovement()->SetDefaultMovementMode();
+
+	IsCharacterDead = false;
+	DeathTime = -1.0f;
+	bIsKnockedDown = false;
+	KnockdownTime = -1.0f;
+	OnRep_IsCharacterDead();
+
+	ForceNetUpdate();
+}
+
+void AGamePlayerCharacter::CaptureSpawnAttributes()
+{
+	if (!IsValid(AbilitySystemComponent))
+	{
+		return;
+	}
+
+	UAttributeSet::GetAttributesFromSetClass(UPlayerAttributeSet::StaticClass(), SpawnAttributes);
+
+	SpawnAttributeValues.Reset(SpawnAttributes.Num());
+	for (const FGameplayAttribute& Attribute : SpawnAttributes)
+	{
+		SpawnAttributeValues.Add(AbilitySystemComponent->GetNumericAttributeBase(Attribute));
+	}
+}
+
+void AGamePlayerCharacter::RestoreSpawnAttributes()
+{
+	if (!IsValid(AbilitySystemComponent))
+	{
+		return;
+	}
+
+	for (int32 Index = 0; Index < SpawnAttributes.Num(); ++Index)
+	{
+		AbilitySystemComponent->SetNumericAttributeBase(SpawnAttributes[Index], SpawnAttributeValues[Index]);
+	}
+}
+
+float AGamePlayerCharacter::GetCharacterHealth() const
+{
+	if (GetLocalRole() == ROLE_SimulatedProxy)
+	{
+		return GetCharacterMaxHealth() * FMath::Min<float>(ProxyHealth, ProxyHealthSteps) / FMath::Max<uint8>(ProxyHealthSteps, 1);
+	}
+
+	if (IsValid(PlayerAttribute))
+	{
+		return PlayerAttribute->GetHealth();
+	}
+
+	return 0.0f;
+}
+
+float AGamePlayerCharacter::GetCharacterMaxHealth() const
+{
+	if (IsValid(PlayerAttribute))
+	{
+		return PlayerAttribute->GetMaxHealth();
+	}
+
+	return 0.0f;
+}
+
+void AGamePlayerCharacter::OnRep_IsCharacterDead()
+{
+	if (IsCharacterDead)
+	{
+		PlayStateMontage(DeathMontage, DeathTime);
+	}
+	else if (UAnimInstance* AnimInstance = GetMesh() ? GetMesh()->GetAnimInstance() : nullptr)
+	{
+		// Pooled character coming back
+		AnimInstance->StopAllMontages(0.0f);
+	}
+}
+
+void AGamePlayerCharacter::PlayStateMontage(UAnimMontage* Montage, float StateStartTime)
+{
+	if (!Montage || GetNetMode() == NM_DedicatedServer || StateStartTime < 0.0f)
+	{
+		return;
+	}
+
+	// Characters becoming relevant long after the event only keep the end state
+	const float Elapsed = FMath::Max(GetServerWorldTime() - StateStartTime, 0.0f);
+	if (Elapsed >= Montage->GetPlayLength())
+	{
+		return;
+	}
+
+	UAnimInstance* AnimInstance = GetMesh() ? GetMesh()->GetAnimInstance() : nullptr;
+	if (AnimInstance)
+	{
+		AnimInstance->Montage_Play(Montage, 1.0f, EMontagePlayReturnType::MontageLength, Elapsed);
+	}
+}
+
+float AGamePlayerCharacter::GetServerWorldTime() const
+{
+	const AGameStateBase* GameState = GetWorld() ? GetWorld()->GetGameState() : nullptr;
+	return GameState ? GameState->GetServerWorldTimeSeconds() : 0.0f;
+}
+
+void AGamePlayerCharacter::AddCharacterAbilities()
+{
+	// Grant abilities, but only on the server	
+	if (GetLocalRole() != ROLE_Authority || !IsValid(AbilitySystemComponent) || bCharacterAbilitiesGiven)
+	{
+		return;
+	}
+
+	for (TSubclassOf<UGameplayAbility>& StartupAbility : CharacterAbilities)
+	{
+		FGameplayAbilitySpecHandle DefaultHandle = AbilitySystemComponent->GiveAbility(FGameplayAbilitySpec(StartupAbility, 1, 1, this));
+		AbilitySystemComponent->TryActivateAbility(DefaultHandle);
+	}
+
+	bCharacterAbilitiesGiven = true;
+}
+
+void AGamePlayerCharacter::InitializeAttributes()
+{
+	if (!IsValid(AbilitySystemComponent))
+	{
+		return;
+	}
+
+	if (!DefaultAttributes)
+	{
+		UE_LOG(LogTemp, Error, TEXT("%s() Missing DefaultAttributes for %s. Please fill in the character's Blueprint."), *FString(__FUNCTION__), *GetName());
+		return;
+	}
+
+	// Can run on Server and Client
+	FGameplayEffectContextHandle EffectContext = AbilitySystemComponent->MakeEffectContext();
+	EffectContext.AddSourceObject(this);
+
+	FGameplayEffectSpecHandle NewHandle = AbilitySystemComponent->MakeOutgoingSpec(DefaultAttributes, 1, EffectContext);
+	if (NewHandle.IsValid())
+	{
+		FActiveGameplayEffectHandle ActiveGEHandle = AbilitySystemComponent->ApplyGameplayEffectSpecToSelf(*NewHandle.Data.Get());
+	}
+}
+
+void AGamePlayerCharacter::AddStartupEffects()
+{
+	if (GetLocalRole() != ROLE_Authority || !IsValid(AbilitySystemComponent) || bStartupEffectsApplied)
+	{
+		return;
+	}
+
+	FGameplayEffectContextHandle EffectContext = AbilitySystemComponent->MakeEffectContext();
+	EffectContext.AddSourceObject(this);
+
+	for (TSubclassOf<UGameplayEffect> GameplayEffect : StartupEffects)
+	{
+		FGameplayEffectSpecHandle NewHandle = AbilitySystemComponent->MakeOutgoingSpec(GameplayEffect, 1, EffectContext);
+		if (NewHandle.IsValid())
+		{
+			FActiveGameplayEffectHandle ActiveGEHandle = AbilitySystemComponent->ApplyGameplayEffectSpecToTarget(*NewHandle.Data.Get(), AbilitySystemComponent);
+		}
+	}
+
+	bStartupEffectsApplied = true;
+}
+
+void AGamePlayerCharacter::HealthChanged(const FOnAttributeChangeData& Data)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SafeZone_HealthChanged);
+	CSV_SCOPED_TIMING_STAT(SafeZone, HealthChanged);
+
+	if (GetLocalRole() == ROLE_Authority)
+	{
+		ASafeZoneGameMode* GameMode = GetSafeZoneGameMode();
+		if (GameMode && GameMode->GetPlayerRegistry().IsValidHandle(PlayerHandle))
+		{
+			GameMode->GetPlayerRegistry().SetHealth(PlayerHandle, Data.NewValue);
+		}
+
+		UpdateProxyHealth(Data.NewValue);
+
+		if (Data.NewValue <= 0.0f)
+		{
+			Die();
+		}
+		else if (Data.NewValue <= KnockdownHealthThreshold && !bIsKnockedDown)
+		{
+			Knockdown();
+		}
+	}
+}
+
+void AGamePlayerCharacter::UpdateProxyHealth(float Health)
+{
+	const float MaxHealth = GetCharacterMaxHealth();
+	const uint8 Steps = FMath::Max<uint8>(ProxyHealthSteps, 1);
+
+	// Rounded up so a living character never shows empty health on the proxies
+	const uint8 NewProxyHealth = MaxHealth > 0.0f ? (uint8)FMath::Clamp(FMath::CeilToInt(Health / MaxHealth * Steps), 0, (int32)Steps) : 0;
+	if (ProxyHealth != NewProxyHealth)
+	{
+		ProxyHealth = NewProxyHealth;
+		MARK_PROPERTY_DIRTY_FROM_NAME(AGamePlayerCharacter, ProxyHealth, this);
+	}
+}
+
+void AGamePlayerCharacter::OutsideSafeZoneTagChanged(const FGameplayTag CallbackTag, int32 NewCount)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SafeZone_OutsideTagChanged);
+	CSV_SCOPED_TIMING_STAT(SafeZone, OutsideTagChanged);
+
+	if (!HasAuthority())
+	{
+		return;
+	}
+
+	ASafeZoneGameMode* GameMode = GetSafeZoneGameMode();
+	if (!GameMode)
+	{
+		return;
+	}
+
+	const bool bOutside = AbilitySystemComponent && AbilitySystemComponent->HasMatchingGameplayTag(OutsideSafeZoneTag);
+
+	// Damage itself is applied by the game mode in one batched pass for every player outside
+	if (bOutside && IsCharacterAlive())
+	{
+		GameMode->GetZoneDamageScheduler().AddPlayer(this);
+	}
+	else
+	{
+		GameMode->GetZoneDamageScheduler().RemovePlayer(this);
+	}
+
+	if (AGamePlayerController* PlayerController = GetController<AGamePlayerController>())
+	{
+		if (IsCharacterAlive())
+		{
+			const FSafeZoneGameplayTags& Tags = FSafeZoneGameplayTags::Get();
+			PlayerController->QueueLocalGameplayCue(bOutside ? Tags.GameplayCue_SafeZone_Exited : Tags.GameplayCue_SafeZone_Entered);
+		}
+	}
+}
+
+void AGamePlayerCharacter::Knockdown()
+{
+	bIsKnockedDown = true;
+	KnockdownTime = GetServerWorldTime();
+	OnRep_IsKnockedDown();
+
+	if (ASafeZoneGameMode* GameMode = GetSafeZoneGameMode())
+	{
+		GameMode->SetPlayerKnocked(PlayerHandle, true);
+	}
+
+	ForceNetUpdate();
+}
+
+void AGamePlayerCharacter::SetHealth(float Health)
+{
+	if (IsValid(PlayerAttribute))
+	{
+		PlayerAttribute->SetHealth(Health);
+	}
+}
+
+void AGamePlayerCharacter::OnRep_IsKnockedDown()
+{
+	//logic when knockeddown
+	//like removing weapons, abilities etc
+	if (bIsKnockedDown)
+	{
+		PlayStateMontage(KnockdownMontage, KnockdownTime);
+	}
+}
+
+void AGamePlayerCharacter::SetPlayerHandle(int32 Handle)
+{
+	if (PlayerHandle != Handle)
+	{
+		PlayerHandle = Handle;
+		MARK_PROPERTY_DIRTY_FROM_NAME(AGamePlayerCharacter, PlayerHandle, this);
+	}
+}
+
+ASafeZoneGameMode* AGamePlayerCharacter::GetSafeZoneGameMode() const
+{
+	UWorld* World = GetWorld();
+	return World ? Cast<ASafeZoneGameMode>(World->GetAuthGameMode()) : nullptr;
+}
+
+FString AGamePlayerCharacter::GetPlayerUniqueNetIdAsString()
+{
+	if (GetPlayerState())
+	{
+		return GetPlayerState()->GetUniqueId().ToString();
+	}
+	return FString();
+}
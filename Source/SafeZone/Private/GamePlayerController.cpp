@@ -1,5 +1,61 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-
-#include "GamePlayerController.h"
-
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "GamePlayerController.h"
+#include "AbilitySystemGlobals.h"
+#include "GameplayCueManager.h"
+
+AGamePlayerController::AGamePlayerController()
+{
+	MaxLocalGameplayCuesPerBatch = 16;
+}
+
+void AGamePlayerController::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (HasAuthority())
+	{
+		PendingLocalGameplayCues.Start(GetWorld(), MaxLocalGameplayCuesPerBatch, [this](const TArray<FSafeZoneLocalGameplayCue>& Cues)
+		{
+			ClientExecuteLocalGameplayCues(Cues);
+		});
+	}
+}
+
+void AGamePlayerController::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+	PendingLocalGameplayCues.Stop();
+
+	Super::EndPlay(EndPlayReason);
+}
+
+void AGamePlayerController::QueueLocalGameplayCue(const FGameplayTag& CueTag, float Magnitude)
+{
+	if (!HasAuthority() || !CueTag.IsValid())
+	{
+		return;
+	}
+
+	FSafeZoneLocalGameplayCue& Cue = PendingLocalGameplayCues.Add();
+	Cue.CueTag = CueTag;
+	Cue.Magnitude = Magnitude;
+}
+
+void AGamePlayerController::ClientExecuteLocalGameplayCues_Implementation(const TArray<FSafeZoneLocalGameplayCue>& Cues)
+{
+	APawn* ControlledPawn = GetPawn();
+	UGameplayCueManager* CueManager = UAbilitySystemGlobals::Get().GetGameplayCueManager();
+	if (!ControlledPawn || !CueManager)
+	{
+		return;
+	}
+
+	for (const FSafeZoneLocalGameplayCue& Cue : Cues)
+	{
+		FGameplayCueParameters Parameters;
+		Parameters.RawMagnitude = Cue.Magnitude;
+		Parameters.Location = ControlledPawn->GetActorLocation();
+		CueManager->HandleGameplayCue(ControlledPawn, Cue.CueTag, EGameplayCueEvent::Executed, Parameters);
+	}
+}
@@ -5,10 +5,11 @@
 #include "GameplayEffectExtension.h"
 #include "Net/UnrealNetwork.h"
 #include "GamePlayerController.h"
+#include "SafeZoneStats.h"
 
 
 UPlayerAttributeSet::UPlayerAttributeSet()
-    : Health(100.0f), MaxHealth(100.0F) // Initialize Health, set default value as needed
+    : Health(100.0f), MaxHealth(100.0F), DamageResistance(0.0f) // Initialize Health, set default value as needed
 {
 }
 
@@ -26,58 +27,12 @@ void UPlayerAttributeSet::PreAttributeChange(const FGameplayAttribute& Attribute
 
 void UPlayerAttributeSet::PostGameplayEffectExecute(const FGameplayEffectModCallbackData& Data)
 {
-	Super::PostGameplayEffectExecute(Data);
-
-	FGameplayEffectContextHandle Context = Data.EffectSpec.GetContext();
-	UAbilitySystemComponent* Source = Context.GetOriginalInstigatorAbilitySystemComponent();
-	const FGameplayTagContainer& SourceTags = *Data.EffectSpec.CapturedSourceTags.GetAggregatedTags();
-	FGameplayTagContainer SpecAssetTags;
-	Data.EffectSpec.GetAllAssetTags(SpecAssetTags);
-
-	// Get the Target actor, which should be our owner
-	AActor* TargetActor = nullptr;
-	AController* TargetController = nullptr;
-	AGamePlayerCharacter* TargetCharacter = nullptr;
-	if (Data.Target.AbilityActorInfo.IsValid() && Data.Target.AbilityActorInfo->AvatarActor.IsValid())
-	{
-		TargetActor = Data.Target.AbilityActorInfo->AvatarActor.Get();
-		TargetController = Data.Target.AbilityActorInfo->PlayerController.Get();
-		TargetCharacter = Cast<AGamePlayerCharacter>(TargetActor);
-	}
-
-	// Get the Source actor
-	AActor* SourceActor = nullptr;
-	AController* SourceController = nullptr;
-	AGamePlayerCharacter* SourceCharacter = nullptr;
-	if (Source && Source->AbilityActorInfo.IsValid() && Source->AbilityActorInfo->AvatarActor.IsValid())
-	{
-		SourceActor = Source->AbilityActorInfo->AvatarActor.Get();
-		SourceController = Source->AbilityActorInfo->PlayerController.Get();
-		if (SourceController == nullptr && SourceActor != nullptr)
-		{
-			if (APawn* Pawn = Cast<APawn>(SourceActor))
-			{
-				SourceController = Pawn->GetController();
-			}
-		}
+	SCOPE_CYCLE_COUNTER(STAT_SafeZone_PostGameplayEffectExecute);
+	CSV_SCOPED_TIMING_STAT(SafeZone, PostGameplayEffectExecute);
 
-		// Use the controller to find the source pawn
-		if (SourceController)
-		{
-			SourceCharacter = Cast<AGamePlayerCharacter>(SourceController->GetPawn());
-		}
-		else
-		{
-			SourceCharacter = Cast<AGamePlayerCharacter>(SourceActor);
-		}
-
-		// Set the causer actor based on context if it's set
-		if (Context.GetEffectCauser())
-		{
-			SourceActor = Context.GetEffectCauser();
-		}
-	}
+	Super::PostGameplayEffectExecute(Data);
 
+	// Source and target are only resolved by the branches that use them
 	if (Data.EvaluatedData.Attribute == GetDamageAttribute())
 	{
 		// Store a local copy of the amount of damage done and clear the damage attribute
@@ -86,26 +41,16 @@ void UPlayerAttributeSet::PostGameplayEffectExecute(const FGameplayEffectModCall
 
 		if (LocalDamageDone > 0.0f)
 		{
+			AActor* TargetActor = Data.Target.AbilityActorInfo.IsValid() ? Data.Target.AbilityActorInfo->AvatarActor.Get() : nullptr;
+			AGamePlayerCharacter* TargetCharacter = Cast<AGamePlayerCharacter>(TargetActor);
+
 			// If character was alive before damage is added, handle damage
 			// This prevents damage being added to dead things and replaying death animations
-			bool WasAlive = true;
+			const bool WasAlive = TargetCharacter ? TargetCharacter->IsCharacterAlive() : true;
 
-			if (TargetCharacter)
-			{
-				WasAlive = TargetCharacter->IsCharacterAlive();
-			}
-
-			if (!TargetCharacter->IsCharacterAlive())
-			{
-				//UE_LOG(LogTemp, Warning, TEXT("%s() %s is NOT alive when receiving damage"), *FString(__FUNCTION__), *TargetCharacter->GetName());
-			}
-
-			if (LocalDamageDone > 0)
-			{
-				// Apply the health change and then clamp it
-				const float NewHealth = GetHealth() - LocalDamageDone;
-				SetHealth(FMath::Clamp(NewHealth, 0.0f, GetMaxHealth()));
-			}
+			// Apply the health change and then clamp it
+			const float NewHealth = GetHealth() - LocalDamageDone;
+			SetHealth(FMath::Clamp(NewHealth, 0.0f, GetMaxHealth()));
 
 			if (TargetCharacter && WasAlive)
 			{
@@ -113,7 +58,9 @@ void UPlayerAttributeSet::PostGameplayEffectExecute(const FGameplayEffectModCall
 				//UE_LOG(LogTemp, Log, TEXT("%s() %s Damage Received: %f"), *FString(__FUNCTION__), *GetOwningActor()->GetName(), LocalDamageDone);
 
 				// Show damage number for the Source player unless it was self damage
-				if (SourceActor != TargetActor)
+				AController* SourceController = nullptr;
+				AActor* SourceActor = ResolveSource(Data, SourceController);
+				if (SourceActor && SourceActor != TargetActor)
 				{
 					AGamePlayerController* PC = Cast<AGamePlayerController>(SourceController);
 					if (PC)
@@ -134,11 +81,43 @@ void UPlayerAttributeSet::PostGameplayEffectExecute(const FGameplayEffectModCall
 	} // Health
 }
 
+AActor* UPlayerAttributeSet::ResolveSource(const FGameplayEffectModCallbackData& Data, AController*& OutSourceController)
+{
+	OutSourceController = nullptr;
+
+	// Zone damage has no instigator and self inflicted damage is its own source
+	const FGameplayEffectContextHandle& Context = Data.EffectSpec.GetContext();
+	UAbilitySystemComponent* Source = Context.GetOriginalInstigatorAbilitySystemComponent();
+	if (!Source || Source == &Data.Target || !Source->AbilityActorInfo.IsValid() || !Source->AbilityActorInfo->AvatarActor.IsValid())
+	{
+		return nullptr;
+	}
+
+	AActor* SourceActor = Source->AbilityActorInfo->AvatarActor.Get();
+	OutSourceController = Source->AbilityActorInfo->PlayerController.Get();
+	if (OutSourceController == nullptr)
+	{
+		if (APawn* Pawn = Cast<APawn>(SourceActor))
+		{
+			OutSourceController = Pawn->GetController();
+		}
+	}
+
+	// Set the causer actor based on context if it's set
+	if (Context.GetEffectCauser())
+	{
+		SourceActor = Context.GetEffectCauser();
+	}
+
+	return SourceActor;
+}
+
 void UPlayerAttributeSet::GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const
 {
 	Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-	DOREPLIFETIME_CONDITION_NOTIFY(UPlayerAttributeSet, Health, COND_None, REPNOTIFY_Always);
+	// Other clients read the quantized health replicated on the character
+	DOREPLIFETIME_CONDITION_NOTIFY(UPlayerAttributeSet, Health, COND_OwnerOnly, REPNOTIFY_Always);
 	DOREPLIFETIME_CONDITION_NOTIFY(UPlayerAttributeSet, MaxHealth, COND_None, REPNOTIFY_Always);
 }
 
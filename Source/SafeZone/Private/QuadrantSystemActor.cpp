@@ -1,99 +1,107 @@
-#include "QuadrantSystemActor.h"
-#include "GamePlayerCharacter.h"
-#include "SafeZoneGameMode.h"
-
-AQuadrantSystemActor::AQuadrantSystemActor()
-{
-    PrimaryActorTick.bCanEverTick = false;
-
-    QuadrantSphere = CreateDefaultSubobject<USphereComponent>(TEXT("QuadrantSphere"));
-    QuadrantSphere->SetSphereRadius(10);
-    QuadrantSphere->bHiddenInGame = false;
-    RootComponent = QuadrantSphere;
-
-    QuadrantSphere->OnComponentBeginOverlap.AddDynamic(this, &AQuadrantSystemActor::OnPlayerEnterQuadrant);
-    QuadrantSphere->OnComponentEndOverlap.AddDynamic(this, &AQuadrantSystemActor::OnPlayerExitQuadrant);
-
-    bReplicates = true;
-}
-
-void AQuadrantSystemActor::BeginPlay()
-{
-    Super::BeginPlay();
-}
-
-void AQuadrantSystemActor::OnPlayerEnterQuadrant(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult)
-{
-    if (!HasAuthority())
-    {
-        return;
-    }
-    AGamePlayerCharacter* PlayerCharacter = Cast<AGamePlayerCharacter>(OtherActor);
-    if (PlayerCharacter)
-    {
-        FString PlayerID = PlayerCharacter->GetPlayerUniqueNetIdAsString();
-        ASafeZoneGameMode* GameMode = Cast<ASafeZoneGameMode>(GetWorld()->GetAuthGameMode());
-        if (GameMode)
-        {
-            GameMode->UpdatePlayerQuadrant(PlayerID, this);
-        }
-
-        PlayersInQuadrant.Add(PlayerCharacter);
-    }
-}
-
-FVector AQuadrantSystemActor::GetRandomLocationInQuadrant() const
-{
-    FVector SphereCenter = QuadrantSphere->GetComponentLocation();
-    float SphereRadius = QuadrantSphere->GetScaledSphereRadius();
-
-    FVector RandomPointInSphere = FMath::RandPointInBox(FBox(SphereCenter - FVector(SphereRadius), SphereCenter + FVector(SphereRadius)));
-
-    return RandomPointInSphere;
-}
-
-void AQuadrantSystemActor::OnPlayerExitQuadrant(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex)
-{
-    if (!HasAuthority())
-    {
-        return;
-    }
-
-    AGamePlayerCharacter* PlayerCharacter = Cast<AGamePlayerCharacter>(OtherActor);
-    if (PlayerCharacter)
-    {
-        FString PlayerID = PlayerCharacter->GetPlayerUniqueNetIdAsString();
-        ASafeZoneGameMode* GameMode = Cast<ASafeZoneGameMode>(GetWorld()->GetAuthGameMode());
-        if (GameMode)
-        {
-            // Start the delay before confirming the player's quadrant status
-            const float QuadrantTransitionDelay = 1.5f; // Adjust the delay time as needed
-            GameMode->StartQuadrantUpdateDelay(PlayerID, QuadrantTransitionDelay);
-        }
-
-        PlayersInQuadrant.Remove(PlayerCharacter);
-    }
-}
-
-TArray<AGamePlayerCharacter*> AQuadrantSystemActor::GetPlayersInQuadrant() const
-{
-    return PlayersInQuadrant;
-}
-
-int32 AQuadrantSystemActor::GetNumberOfPlayersInQuadrant() const
-{
-    return PlayersInQuadrant.Num();
-}
-
-bool AQuadrantSystemActor::IsPlayerInside(const FString& PlayerID) const
-{
-    for (AActor* Player : PlayersInQuadrant)
-    {
-        AGamePlayerCharacter* PlayerCharacter = Cast<AGamePlayerCharacter>(Player);
-        if (PlayerCharacter && PlayerCharacter->GetPlayerUniqueNetIdAsString() == PlayerID)
-        {
-            return true; // PlayerID matches a player in the quadrant
-        }
-    }
-    return false; // PlayerID not found in this quadrant
-}
\ No newline at end of file
+#include "QuadrantSystemActor.h"
+#include "SafeZoneActor.h"
+#include "SafeZoneGameMode.h"
+
+TArray<AGamePlayerCharacter*> FSafeZoneQuadrant::GetPlayersInQuadrant(const FSafeZonePlayerRegistry& PlayerRegistry) const
+{
+    TArray<AGamePlayerCharacter*> PlayersInQuadrant;
+    for (const int32 PlayerHandle : PlayerHandlesInQuadrant)
+    {
+        AGamePlayerCharacter* PlayerCharacter = PlayerRegistry.IsValidHandle(PlayerHandle) ? PlayerRegistry.GetCharacter(PlayerHandle) : nullptr;
+        if (PlayerCharacter)
+        {
+            PlayersInQuadrant.Add(PlayerCharacter);
+        }
+    }
+    return PlayersInQuadrant;
+}
+
+int32 FSafeZoneQuadrant::GetNumberOfPlayersInQuadrant() const
+{
+    return PlayerHandlesInQuadrant.Num();
+}
+
+FVector FSafeZoneQuadrant::GetRandomLocationInQuadrant() const
+{
+    FVector RandomPointInSphere = FMath::RandPointInBox(FBox(Center - FVector(Radius), Center + FVector(Radius)));
+
+    return RandomPointInSphere;
+}
+
+bool FSafeZoneQuadrant::IsPlayerInside(int32 PlayerHandle) const
+{
+    return PlayerHandlesInQuadrant.Contains(PlayerHandle);
+}
+
+void FSafeZoneQuadrant::ResetPlayersInQuadrant()
+{
+    PlayerHandlesInQuadrant.Reset();
+}
+
+void FSafeZoneQuadrant::AddPlayerToQuadrant(int32 PlayerHandle)
+{
+    PlayerHandlesInQuadrant.Add(PlayerHandle);
+}
+
+AQuadrantSystemActor::AQuadrantSystemActor()
+{
+    PrimaryActorTick.bCanEverTick = false;
+
+    QuadrantSphere = CreateDefaultSubobject<USphereComponent>(TEXT("QuadrantSphere"));
+    QuadrantSphere->SetSphereRadius(10);
+    QuadrantSphere->bHiddenInGame = false;
+    // Visualization only, quadrant occupancy comes from the game mode membership pass
+    QuadrantSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    QuadrantSphere->SetGenerateOverlapEvents(false);
+    RootComponent = QuadrantSphere;
+
+    SafeZone = nullptr;
+    QuadrantIndex = INDEX_NONE;
+
+    bReplicates = false;
+}
+
+void AQuadrantSystemActor::BeginPlay()
+{
+    Super::BeginPlay();
+}
+
+void AQuadrantSystemActor::SetQuadrant(ASafeZoneActor* InSafeZone, int32 InQuadrantIndex)
+{
+    SafeZone = InSafeZone;
+    QuadrantIndex = InQuadrantIndex;
+}
+
+const FSafeZoneQuadrant* AQuadrantSystemActor::GetQuadrant() const
+{
+    if (SafeZone && SafeZone->GetQuadrantsInSafeZone().IsValidIndex(QuadrantIndex))
+    {
+        return &SafeZone->GetQuadrantsInSafeZone()[QuadrantIndex];
+    }
+    return nullptr;
+}
+
+FVector AQuadrantSystemActor::GetRandomLocationInQuadrant() const
+{
+    const FSafeZoneQuadrant* Quadrant = GetQuadrant();
+    return Quadrant ? Quadrant->GetRandomLocationInQuadrant() : GetActorLocation();
+}
+
+TArray<AGamePlayerCharacter*> AQuadrantSystemActor::GetPlayersInQuadrant() const
+{
+    const FSafeZoneQuadrant* Quadrant = GetQuadrant();
+    ASafeZoneGameMode* GameMode = GetWorld() ? GetWorld()->GetAuthGameMode<ASafeZoneGameMode>() : nullptr;
+    return Quadrant && GameMode ? Quadrant->GetPlayersInQuadrant(GameMode->GetPlayerRegistry()) : TArray<AGamePlayerCharacter*>();
+}
+
+int32 AQuadrantSystemActor::GetNumberOfPlayersInQuadrant() const
+{
+    const FSafeZoneQuadrant* Quadrant = GetQuadrant();
+    return Quadrant ? Quadrant->GetNumberOfPlayersInQuadrant() : 0;
+}
+
+bool AQuadrantSystemActor::IsPlayerInside(int32 PlayerHandle) const
+{
+    const FSafeZoneQuadrant* Quadrant = GetQuadrant();
+    return Quadrant && Quadrant->IsPlayerInside(PlayerHandle);
+}
@@ -1,243 +1,480 @@
-#include "SafeZoneActor.h"
-#include "QuadrantSystemActor.h"
-#include "Net/UnrealNetwork.h"
-
-
-ASafeZoneActor::ASafeZoneActor()
-{
-    PrimaryActorTick.bCanEverTick = true;
-
-    SafeZoneSphere = CreateDefaultSubobject<USphereComponent>(TEXT("SafeZoneSphere"));
-    SafeZoneSphere->InitSphereRadius(2500.0); //can be set using a var
-    RootComponent = SafeZoneSphere;
-
-    SafeZoneVisual = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("SafeZoneVisual"));
-    SafeZoneVisual->SetupAttachment(RootComponent);
-
-    // Load the sphere mesh
-    static ConstructorHelpers::FObjectFinder<UStaticMesh> SphereMesh(TEXT("StaticMesh'/Game/Mesh/SafeZoneSphere.SafeZoneSphere'"));
-    if (SphereMesh.Succeeded())
-    {
-        SafeZoneVisual->SetStaticMesh(SphereMesh.Object);
-    }
-
-    SafeZoneVisual->SetCollisionEnabled(ECollisionEnabled::NoCollision);
-
-    // Assuming the mesh radius is approximately 50 units
-    float MeshRadius = 50.0f;
-    float InitialScale = SafeZoneSphere->GetScaledSphereRadius() / MeshRadius;
-    SafeZoneVisual->SetWorldScale3D(FVector(InitialScale, InitialScale, InitialScale));
-
-    // Load the material (if needed)
-    /* ... */
-
-    ShrinkSpeed = 0.5f;
-    MaxIterations = 5;
-    bShouldShrink = false;
-    CurrentIteration = 0;
-    MinSafeZoneRadius = 1;
-
-    bReplicates = true;
-}
-
-void ASafeZoneActor::BeginPlay()
-{
-    Super::BeginPlay();
-
-    if (HasAuthority())
-    {
-        TargetLocation = GetActorLocation();
-        TargetRadius = SafeZoneSphere->GetScaledSphereRadius();
-        CreateQuadrants();
-        StartShrinkingWithDelay(30.0f);
-    }
-}
-
-void ASafeZoneActor::Tick(float DeltaTime)
-{
-    Super::Tick(DeltaTime);
-
-    if (bShouldShrink)
-    {
-        UpdateSafeZoneProperties();
-    }
-}
-
-void ASafeZoneActor::GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const
-{
-    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
-
-    DOREPLIFETIME(ASafeZoneActor, TargetLocation);
-    DOREPLIFETIME(ASafeZoneActor, TargetRadius);
-    DOREPLIFETIME(ASafeZoneActor, bShouldShrink);
-}
-
-void ASafeZoneActor::OnRep_UpdateSafeZone()
-{
-}
-
-void ASafeZoneActor::CreateQuadrants()
-{
-    // Clear existing quadrants
-    for (AQuadrantSystemActor* Quadrant : Quadrants)
-    {
-        if (Quadrant)
-        {
-            Quadrant->Destroy();
-        }
-    }
-    Quadrants.Empty();
-
-    FVector SphereCenter = GetActorLocation();
-    float SphereRadius = SafeZoneSphere->GetScaledSphereRadius();
-    float QuadrantRadius = SphereRadius / 2.0f;
-    float AngleStep = 90.0f; // 90 degrees separation for 4 quadrants
-
-    // Create quadrant actors
-    for (int i = 0; i < 4; ++i)
-    {
-        float Angle = FMath::DegreesToRadians(AngleStep * i);
-        FVector Offset = FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.0f) * QuadrantRadius;
-        FVector QuadrantLocation = SphereCenter + Offset;
-        AQuadrantSystemActor* NewQuadrant = GetWorld()->SpawnActor<AQuadrantSystemActor>(QuadrantLocation, FRotator::ZeroRotator);
-        if (NewQuadrant)
-        {
-            NewQuadrant->QuadrantSphere->SetSphereRadius(QuadrantRadius);
-            Quadrants.Add(NewQuadrant);
-        }
-    }
-}
-
-void ASafeZoneActor::UpdateQuadrants(float NewRadius, FVector NewCenter)
-{
-    float QuadrantRadius = NewRadius / 2.0f;
-    float AngleStep = 90.0f;
-
-    int i = 0;
-    for (AQuadrantSystemActor* Quadrant : Quadrants)
-    {
-        if (Quadrant)
-        {
-            float Angle = FMath::DegreesToRadians(AngleStep * i++);
-            FVector Offset = FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.0f) * QuadrantRadius;
-            FVector NewLocation = NewCenter + Offset;
-            Quadrant->SetActorLocation(NewLocation);
-            Quadrant->QuadrantSphere->SetSphereRadius(QuadrantRadius);
-        }
-    }
-}
-
-void ASafeZoneActor::StartShrinkingWithDelay(float DelayInSeconds)
-{
-    // Clear any existing timers
-    GetWorldTimerManager().ClearTimer(ShrinkDelayTimerHandle);
-
-    // Set a timer to start the shrinking process after the specified delay
-    GetWorldTimerManager().SetTimer(ShrinkDelayTimerHandle, this, &ASafeZoneActor::ShrinkSafeZone, DelayInSeconds, false);
-}
-
-void ASafeZoneActor::UpdateSafeZoneProperties()
-{
-    FVector CurrentLocation = GetActorLocation();
-    float CurrentRadius = SafeZoneSphere->GetScaledSphereRadius();
-
-    FVector TargetLocationXY(TargetLocation.X, TargetLocation.Y, CurrentLocation.Z);
-    FVector NewLocationXY = FMath::VInterpTo(CurrentLocation, TargetLocationXY, GetWorld()->GetDeltaSeconds(), ShrinkSpeed);
-
-    float NewRadius = FMath::FInterpTo(CurrentRadius, TargetRadius, GetWorld()->GetDeltaSeconds(), ShrinkSpeed);
-
-    FVector MoveDirection = (TargetLocationXY - CurrentLocation).GetSafeNormal();
-    float MoveDistance = FVector::Dist(CurrentLocation, TargetLocationXY) * FMath::Min(GetWorld()->GetDeltaSeconds() * ShrinkSpeed, 1.0f);
-    FVector NewLocation = CurrentLocation + MoveDirection * MoveDistance;
-
-    MoveSafeZone(NewLocation);
-    SafeZoneSphere->SetSphereRadius(NewRadius);
-
-    float SphereScale = NewRadius / 50.0f; // Adjust if your sphere mesh has a different default radius
-    SafeZoneVisual->SetWorldScale3D(FVector(SphereScale, SphereScale, SphereScale));
-
-    UpdateQuadrants(NewRadius, NewLocation); // Update quadrants as well
-
-    if (NewLocation.Equals(TargetLocationXY, 2.0f) && FMath::IsNearlyEqual(NewRadius, TargetRadius, 1.0f))
-    {
-        if (HasAuthority())
-        {
-            bShouldShrink = false;
-        }
-        
-        CurrentIteration++;
-
-        if (CurrentIteration >= MaxIterations)
-        {
-            // Handle end of shrinking process
-        }
-        else
-        {
-            // Prepare for the next shrink phase
-        }
-    }
-}
-
-// Add a function to find the quadrant with the minimum number of players
-AQuadrantSystemActor* ASafeZoneActor::FindQuadrantWithMinimumPlayers()
-{
-    AQuadrantSystemActor* MinPlayersQuadrant = nullptr;
-    int32 MinPlayers = MAX_int32;
-
-    for (AQuadrantSystemActor* Quadrant : Quadrants)
-    {
-        if (Quadrant)
-        {
-            int32 NumPlayersInQuadrant = Quadrant->GetNumberOfPlayersInQuadrant(); // Implement GetNumPlayers() in AQuadrantSystemActor
-
-            if (NumPlayersInQuadrant < MinPlayers)
-            {
-                MinPlayers = NumPlayersInQuadrant;
-                MinPlayersQuadrant = Quadrant;
-            }
-        }
-    }
-
-    return MinPlayersQuadrant;
-}
-
-// Modify the ShrinkSafeZone function to incorporate the new logic
-void ASafeZoneActor::ShrinkSafeZone()
-{
-	if (!HasAuthority())
-    {
-        return;
-    }
-
-    if (CurrentIteration == MaxIterations - 1)
-    {
-        TargetRadius = 0.0f;
-    }
-    else
-    {
-        AQuadrantSystemActor* TargetQuadrant = FindQuadrantWithMinimumPlayers();
-
-        if (TargetQuadrant)
-        {
-            TargetLocation = TargetQuadrant->GetRandomLocationInQuadrant();
-            TargetRadius = FMath::Max(TargetQuadrant->QuadrantSphere->GetScaledSphereRadius(), (float)MinSafeZoneRadius);
-        }
-        else
-        {
-            UE_LOG(LogTemp, Warning, TEXT("No valid target quadrant found."));
-        }
-    }
-
-    bShouldShrink = true;
-}
-
-// Modify the MoveSafeZone function to remove existing quadrants and generate new ones
-void ASafeZoneActor::MoveSafeZone(FVector NewLocation)
-{
-      SetActorLocation(NewLocation);
-
-      if (HasAuthority())
-      {
-          StartShrinkingWithDelay(30.0f);
-      }    
-}
+#include "SafeZoneActor.h"
+#include "QuadrantSystemActor.h"
+#include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "GameFramework/GameStateBase.h"
+#include "SafeZoneStats.h"
+#include "SafeZoneSubsystem.h"
+
+
+ASafeZoneActor::ASafeZoneActor()
+{
+    PrimaryActorTick.bCanEverTick = true;
+
+    SafeZoneSphere = CreateDefaultSubobject<USphereComponent>(TEXT("SafeZoneSphere"));
+    SafeZoneSphere->InitSphereRadius(2500.0); //can be set using a var
+    // Membership is resolved by the game mode against the zone circle, the sphere only carries the radius
+    SafeZoneSphere->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+    SafeZoneSphere->SetGenerateOverlapEvents(false);
+    RootComponent = SafeZoneSphere;
+
+    SafeZoneVisual = CreateDefaultSubobject<UStaticMeshComponent>(TEXT("SafeZoneVisual"));
+    SafeZoneVisual->SetupAttachment(RootComponent);
+
+    // Load the sphere mesh
+    static ConstructorHelpers::FObjectFinder<UStaticMesh> SphereMesh(TEXT("StaticMesh'/Game/Mesh/SafeZoneSphere.SafeZoneSphere'"));
+    if (SphereMesh.Succeeded())
+    {
+        SafeZoneVisual->SetStaticMesh(SphereMesh.Object);
+    }
+
+    SafeZoneVisual->SetCollisionEnabled(ECollisionEnabled::NoCollision);
+
+    // Assuming the mesh radius is approximately 50 units
+    float MeshRadius = 50.0f;
+    float InitialScale = SafeZoneSphere->GetScaledSphereRadius() / MeshRadius;
+    SafeZoneVisual->SetWorldScale3D(FVector(InitialScale, InitialScale, InitialScale));
+
+    // Load the material (if needed)
+    /* ... */
+
+    ZoneKind = ESafeZoneKind::Safe;
+    ShrinkDuration = 20.0f;
+    ShrinkDelay = 30.0f;
+    MaxIterations = 5;
+    bShowQuadrantDebugActors = false;
+    PlayerGridCellSize = 500.0f;
+    NetQuantizePrecision = 1.0f;
+    CurrentIteration = 0;
+    bZoneActivated = false;
+    InitialCenter = FVector::ZeroVector;
+    InitialRadius = 0.0f;
+    MinSafeZoneRadius = 1;
+
+    // Only ticks while a shrink phase is running
+    PrimaryActorTick.bStartWithTickEnabled = false;
+
+    bReplicates = true;
+    // Every client needs the zone wherever it is on the map
+    bAlwaysRelevant = true;
+    // The phase only changes a few times per match, it is marked dirty and pushed with ForceNetUpdate
+    NetUpdateFrequency = 1.0f;
+}
+
+void FSafeZonePhase::Evaluate(float ServerTime, FVector& OutCenter, float& OutRadius) const
+{
+    const float Alpha = Duration > 0.0f ? FMath::Clamp((ServerTime - StartTime) / Duration, 0.0f, 1.0f) : 1.0f;
+
+    OutCenter = FMath::Lerp(StartCenter, EndCenter, Alpha);
+    OutRadius = FMath::Lerp(StartRadius, EndRadius, Alpha);
+}
+
+namespace SafeZonePhaseNet
+{
+    static float QuantizeValue(float Value, float Precision)
+    {
+        return FMath::RoundToFloat(Value / Precision) * Precision;
+    }
+
+    // Signed steps of Precision, zigzag encoded so small negative values stay small when packed
+    static void SerializeQuantized(FArchive& Ar, float& Value, float Precision)
+    {
+        if (Ar.IsSaving())
+        {
+            const int32 Steps = FMath::RoundToInt(Value / Precision);
+            uint32 Packed = ((uint32)Steps << 1) ^ (uint32)(Steps >> 31);
+            Ar.SerializeIntPacked(Packed);
+        }
+        else
+        {
+            uint32 Packed = 0;
+            Ar.SerializeIntPacked(Packed);
+            const int32 Steps = (int32)(Packed >> 1) ^ -(int32)(Packed & 1);
+            Value = Steps * Precision;
+        }
+    }
+
+    static void SerializeQuantized(FArchive& Ar, FVector& Value, float Precision)
+    {
+        SerializeQuantized(Ar, Value.X, Precision);
+        SerializeQuantized(Ar, Value.Y, Precision);
+        SerializeQuantized(Ar, Value.Z, Precision);
+    }
+}
+
+void FSafeZonePhase::Quantize()
+{
+    Precision = FMath::Max(Precision, 0.01f);
+
+    StartCenter.X = SafeZonePhaseNet::QuantizeValue(StartCenter.X, Precision);
+    StartCenter.Y = SafeZonePhaseNet::QuantizeValue(StartCenter.Y, Precision);
+    StartCenter.Z = SafeZonePhaseNet::QuantizeValue(StartCenter.Z, Precision);
+    EndCenter.X = SafeZonePhaseNet::QuantizeValue(EndCenter.X, Precision);
+    EndCenter.Y = SafeZonePhaseNet::QuantizeValue(EndCenter.Y, Precision);
+    EndCenter.Z = SafeZonePhaseNet::QuantizeValue(EndCenter.Z, Precision);
+    StartRadius = SafeZonePhaseNet::QuantizeValue(StartRadius, Precision);
+    EndRadius = SafeZonePhaseNet::QuantizeValue(EndRadius, Precision);
+}
+
+bool FSafeZonePhase::NetSerialize(FArchive& Ar, UPackageMap* Map, bool& bOutSuccess)
+{
+    Ar << PhaseIndex;
+    Ar << StartTime;
+    Ar << Duration;
+    Ar << Precision;
+
+    if (Ar.IsLoading())
+    {
+        // Never divide by a corrupted step
+        Precision = FMath::Max(Precision, 0.01f);
+    }
+
+    SafeZonePhaseNet::SerializeQuantized(Ar, StartCenter, Precision);
+    SafeZonePhaseNet::SerializeQuantized(Ar, EndCenter, Precision);
+    SafeZonePhaseNet::SerializeQuantized(Ar, StartRadius, Precision);
+    SafeZonePhaseNet::SerializeQuantized(Ar, EndRadius, Precision);
+
+    bOutSuccess = !Ar.IsError();
+    return true;
+}
+
+void ASafeZoneActor::BeginPlay()
+{
+    Super::BeginPlay();
+
+    if (HasAuthority())
+    {
+        // Publish the resting zone so late joiners start from the right state
+        ShrinkPhase.StartTime = GetServerWorldTime();
+        ShrinkPhase.Duration = 0.0f;
+        ShrinkPhase.StartCenter = GetActorLocation();
+        ShrinkPhase.EndCenter = ShrinkPhase.StartCenter;
+        ShrinkPhase.StartRadius = SafeZoneSphere->GetScaledSphereRadius();
+        ShrinkPhase.EndRadius = ShrinkPhase.StartRadius;
+        ShrinkPhase.PhaseIndex = 0;
+        PublishShrinkPhase();
+        InitialCenter = ShrinkPhase.StartCenter;
+        InitialRadius = ShrinkPhase.StartRadius;
+
+        // The zone never grows, so a grid over the initial zone covers every later phase
+        PlayerGrid.Initialize(FVector2D(ShrinkPhase.StartCenter), ShrinkPhase.StartRadius, PlayerGridCellSize);
+
+        CreateQuadrants();
+    }
+
+    if (USafeZoneSubsystem* ZoneSubsystem = GetWorld()->GetSubsystem<USafeZoneSubsystem>())
+    {
+        ZoneSubsystem->RegisterZone(this);
+    }
+}
+
+void ASafeZoneActor::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    if (USafeZoneSubsystem* ZoneSubsystem = GetWorld()->GetSubsystem<USafeZoneSubsystem>())
+    {
+        ZoneSubsystem->UnregisterZone(this);
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void ASafeZoneActor::Tick(float DeltaTime)
+{
+    Super::Tick(DeltaTime);
+
+    const float ServerTime = GetServerWorldTime();
+    UpdateSafeZoneProperties(ServerTime);
+
+    // Clients stop once they reached the end of the phase, the server stops in FinishShrinkPhase
+    if (!HasAuthority() && ServerTime >= ShrinkPhase.GetEndTime())
+    {
+        SetActorTickEnabled(false);
+    }
+}
+
+void ASafeZoneActor::GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const
+{
+    Super::GetLifetimeReplicatedProps(OutLifetimeProps);
+
+    // Only compared and sent after PublishShrinkPhase marked it dirty
+    FDoRepLifetimeParams Params;
+    Params.bIsPushBased = true;
+    DOREPLIFETIME_WITH_PARAMS_FAST(ASafeZoneActor, ShrinkPhase, Params);
+}
+
+void ASafeZoneActor::PublishShrinkPhase()
+{
+    ShrinkPhase.Precision = NetQuantizePrecision;
+    ShrinkPhase.Quantize();
+
+    MARK_PROPERTY_DIRTY_FROM_NAME(ASafeZoneActor, ShrinkPhase, this);
+    ForceNetUpdate();
+}
+
+void ASafeZoneActor::OnRep_ShrinkPhase()
+{
+    if (!ShrinkPhase.IsValid())
+    {
+        return;
+    }
+
+    // Snap to the current state right away, this also covers late joiners
+    UpdateSafeZoneProperties(GetServerWorldTime());
+    SetActorTickEnabled(true);
+}
+
+void ASafeZoneActor::GetCurrentZone(FVector& OutCenter, float& OutRadius) const
+{
+    if (ShrinkPhase.IsValid())
+    {
+        ShrinkPhase.Evaluate(GetServerWorldTime(), OutCenter, OutRadius);
+    }
+    else
+    {
+        OutCenter = GetActorLocation();
+        OutRadius = SafeZoneSphere->GetScaledSphereRadius();
+    }
+}
+
+float ASafeZoneActor::GetServerWorldTime() const
+{
+    const UWorld* World = GetWorld();
+    if (!World)
+    {
+        return 0.0f;
+    }
+
+    const AGameStateBase* GameState = World->GetGameState();
+    return GameState ? GameState->GetServerWorldTimeSeconds() : World->GetTimeSeconds();
+}
+
+void ASafeZoneActor::CreateQuadrants()
+{
+    // Clear existing quadrants
+    for (AQuadrantSystemActor* DebugActor : QuadrantDebugActors)
+    {
+        if (DebugActor)
+        {
+            DebugActor->Destroy();
+        }
+    }
+    QuadrantDebugActors.Empty();
+
+    // 4 quadrants, 90 degrees apart
+    Quadrants.Reset();
+    Quadrants.SetNum(4);
+
+    if (bShowQuadrantDebugActors)
+    {
+        for (int32 i = 0; i < Quadrants.Num(); ++i)
+        {
+            AQuadrantSystemActor* DebugActor = GetWorld()->SpawnActor<AQuadrantSystemActor>(GetActorLocation(), FRotator::ZeroRotator);
+            if (DebugActor)
+            {
+                DebugActor->SetQuadrant(this, i);
+                QuadrantDebugActors.Add(DebugActor);
+            }
+        }
+    }
+
+    UpdateQuadrants(SafeZoneSphere->GetScaledSphereRadius(), GetActorLocation());
+}
+
+void ASafeZoneActor::UpdateQuadrants(float NewRadius, FVector NewCenter)
+{
+    SCOPE_CYCLE_COUNTER(STAT_SafeZone_QuadrantUpdate);
+    CSV_SCOPED_TIMING_STAT(SafeZone, QuadrantUpdate);
+
+    float QuadrantRadius = NewRadius / 2.0f;
+    float AngleStep = 90.0f;
+
+    for (int32 i = 0; i < Quadrants.Num(); ++i)
+    {
+        float Angle = FMath::DegreesToRadians(AngleStep * i);
+        FVector Offset = FVector(FMath::Cos(Angle), FMath::Sin(Angle), 0.0f) * QuadrantRadius;
+        Quadrants[i].Center = NewCenter + Offset;
+        Quadrants[i].Radius = QuadrantRadius;
+    }
+
+    for (int32 i = 0; i < QuadrantDebugActors.Num(); ++i)
+    {
+        if (QuadrantDebugActors[i] && Quadrants.IsValidIndex(i))
+        {
+            QuadrantDebugActors[i]->SetActorLocation(Quadrants[i].Center);
+            QuadrantDebugActors[i]->QuadrantSphere->SetSphereRadius(Quadrants[i].Radius);
+        }
+    }
+}
+
+void ASafeZoneActor::TrackPlayer(int32 PlayerHandle, const FVector& Position)
+{
+    if (!PlayerGrid.IsInitialized() || PlayerHandle < 0)
+    {
+        return;
+    }
+
+    while (PlayerGridItems.Num() <= PlayerHandle)
+    {
+        PlayerGridItems.Add(INDEX_NONE);
+    }
+
+    if (PlayerGridItems[PlayerHandle] == INDEX_NONE)
+    {
+        PlayerGridItems[PlayerHandle] = PlayerGrid.AddItem(FVector2D(Position));
+    }
+    else
+    {
+        PlayerGrid.MoveItem(PlayerGridItems[PlayerHandle], FVector2D(Position));
+    }
+}
+
+void ASafeZoneActor::UntrackPlayer(int32 PlayerHandle)
+{
+    if (PlayerGridItems.IsValidIndex(PlayerHandle) && PlayerGridItems[PlayerHandle] != INDEX_NONE)
+    {
+        PlayerGrid.RemoveItem(PlayerGridItems[PlayerHandle]);
+        PlayerGridItems[PlayerHandle] = INDEX_NONE;
+    }
+}
+
+void ASafeZoneActor::ActivateZone()
+{
+    if (!HasAuthority() || bZoneActivated)
+    {
+        return;
+    }
+
+    bZoneActivated = true;
+    StartShrinkingWithDelay(ShrinkDelay);
+}
+
+void ASafeZoneActor::ResetZone()
+{
+    if (!HasAuthority())
+    {
+        return;
+    }
+
+    GetWorldTimerManager().ClearTimer(ShrinkDelayTimerHandle);
+    GetWorldTimerManager().ClearTimer(ShrinkPhaseTimerHandle);
+    SetActorTickEnabled(false);
+
+    CurrentIteration = 0;
+    bZoneActivated = false;
+
+    ShrinkPhase.StartTime = GetServerWorldTime();
+    ShrinkPhase.Duration = 0.0f;
+    ShrinkPhase.StartCenter = InitialCenter;
+    ShrinkPhase.EndCenter = InitialCenter;
+    ShrinkPhase.StartRadius = InitialRadius;
+    ShrinkPhase.EndRadius = InitialRadius;
+    ShrinkPhase.PhaseIndex = 0;
+    PublishShrinkPhase();
+
+    // Drops every player item
+    PlayerGrid.Initialize(FVector2D(InitialCenter), InitialRadius, PlayerGridCellSize);
+    PlayerGridItems.Reset();
+
+    for (FSafeZoneQuadrant& Quadrant : Quadrants)
+    {
+        Quadrant.ResetPlayersInQuadrant();
+    }
+
+    UpdateSafeZoneProperties(ShrinkPhase.StartTime);
+}
+
+void ASafeZoneActor::StartShrinkingWithDelay(float DelayInSeconds)
+{
+    // Clear any existing timers
+    GetWorldTimerManager().ClearTimer(ShrinkDelayTimerHandle);
+
+    // Set a timer to start the shrinking process after the specified delay
+    GetWorldTimerManager().SetTimer(ShrinkDelayTimerHandle, this, &ASafeZoneActor::ShrinkSafeZone, DelayInSeconds, false);
+}
+
+void ASafeZoneActor::UpdateSafeZoneProperties(float ServerTime)
+{
+    SCOPE_CYCLE_COUNTER(STAT_SafeZone_ZoneInterpolation);
+    CSV_SCOPED_TIMING_STAT(SafeZone, ZoneInterpolation);
+
+    if (!ShrinkPhase.IsValid())
+    {
+        return;
+    }
+
+    FVector NewLocation;
+    float NewRadius;
+    ShrinkPhase.Evaluate(ServerTime, NewLocation, NewRadius);
+
+    SetActorLocation(NewLocation);
+    SafeZoneSphere->SetSphereRadius(NewRadius);
+
+    float SphereScale = NewRadius / 50.0f; // Adjust if your sphere mesh has a different default radius
+    SafeZoneVisual->SetWorldScale3D(FVector(SphereScale, SphereScale, SphereScale));
+
+    UpdateQuadrants(NewRadius, NewLocation); // Update quadrants as well
+}
+
+// Modify the ShrinkSafeZone function to incorporate the new logic
+void ASafeZoneActor::ShrinkSafeZone()
+{
+	if (!HasAuthority())
+    {
+        return;
+    }
+
+    SCOPE_CYCLE_COUNTER(STAT_SafeZone_TargetSelection);
+    CSV_SCOPED_TIMING_STAT(SafeZone, TargetSelection);
+
+    const float ServerTime = GetServerWorldTime();
+
+    FVector CurrentLocation;
+    float CurrentRadius;
+    ShrinkPhase.Evaluate(ServerTime, CurrentLocation, CurrentRadius);
+
+    FVector TargetLocation = CurrentLocation;
+    float TargetRadius = CurrentRadius;
+
+    if (CurrentIteration == MaxIterations - 1)
+    {
+        TargetRadius = 0.0f;
+    }
+    else
+    {
+        // Halve the zone around the least populated region that still fits inside the current zone
+        TargetRadius = FMath::Max(CurrentRadius / 2.0f, (float)MinSafeZoneRadius);
+        const FVector2D TargetCenter = PlayerGrid.FindLeastPopulatedRegion(FVector2D(CurrentLocation), CurrentRadius, TargetRadius);
+        TargetLocation = FVector(TargetCenter, CurrentLocation.Z);
+    }
+
+    ShrinkPhase.StartTime = ServerTime;
+    ShrinkPhase.Duration = ShrinkDuration;
+    ShrinkPhase.StartCenter = CurrentLocation;
+    ShrinkPhase.EndCenter = TargetLocation;
+    ShrinkPhase.StartRadius = CurrentRadius;
+    ShrinkPhase.EndRadius = TargetRadius;
+    ShrinkPhase.PhaseIndex = (uint8)FMath::Min(CurrentIteration + 1, 255);
+    PublishShrinkPhase();
+
+    SetActorTickEnabled(true);
+    GetWorldTimerManager().SetTimer(ShrinkPhaseTimerHandle, this, &ASafeZoneActor::FinishShrinkPhase, FMath::Max(ShrinkDuration, KINDA_SMALL_NUMBER), false);
+}
+
+void ASafeZoneActor::FinishShrinkPhase()
+{
+    // Land exactly on the phase target before going idle
+    UpdateSafeZoneProperties(ShrinkPhase.GetEndTime());
+    SetActorTickEnabled(false);
+
+    CurrentIteration++;
+
+    if (CurrentIteration >= MaxIterations)
+    {
+        // Handle end of shrinking process
+    }
+    else
+    {
+        // Prepare for the next shrink phase
+        StartShrinkingWithDelay(ShrinkDelay);
+    }
+}
@@ -0,0 +1,1009 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+// Development console commands that measure the SafeZone hot paths in a running world.
+
+#include "CoreMinimal.h"
+#include "HAL/IConsoleManager.h"
+#include "Engine/World.h"
+#include "Engine/CollisionProfile.h"
+#include "Components/CapsuleComponent.h"
+#include "Components/SphereComponent.h"
+#include "SafeZoneMembership.h"
+#include "SafeZoneCharacterPool.h"
+#include "SafeZoneGameMode.h"
+#include "GamePlayerCharacter.h"
+#include "AIController.h"
+#include "GameplayEffect.h"
+#include "AbilitySystemGlobals.h"
+#include "SafeZoneGameplayTags.h"
+#include "SafeZoneDamageScheduler.h"
+#include "DamageGE_ExecutionCalculation.h"
+#include "ZoneDamageGE_ExecutionCalculation.h"
+#include "GameplayEffectExecutionCalculation.h"
+#include "PlayerAttributeSet.h"
+#include "EngineUtils.h"
+#include "TimerManager.h"
+#include "Engine/NetDriver.h"
+#include "Engine/NetConnection.h"
+#include "Abilities/GameplayAbility.h"
+#include "Serialization/ArchiveCountMem.h"
+
+#if !UE_BUILD_SHIPPING
+
+namespace SafeZoneBenchmarks
+{
+	// Zone dimensions used by the benchmarks, matches the default ASafeZoneActor
+	static const float ZoneRadius = 2500.0f;
+
+	// Exit hysteresis of the membership benchmark, matches the default ASafeZoneGameMode
+	static const float ZoneExitHysteresis = 100.0f;
+
+	static TArray<int32> ParseCounts(const TArray<FString>& Args, const TArray<int32>& Defaults)
+	{
+		TArray<int32> Counts;
+		for (const FString& Arg : Args)
+		{
+			const int32 Count = FCString::Atoi(*Arg);
+			if (Count > 0)
+			{
+				Counts.Add(Count);
+			}
+		}
+		return Counts.Num() > 0 ? Counts : Defaults;
+	}
+
+	// The authority SafeZone game mode of the world and the character class the benchmarks spawn, null with a warning naming the command without one
+	static ASafeZoneGameMode* GetGameModeAndPawnClass(UWorld* World, const TCHAR* CommandName, UClass*& OutPawnClass)
+	{
+		ASafeZoneGameMode* GameMode = World ? World->GetAuthGameMode<ASafeZoneGameMode>() : nullptr;
+		if (!GameMode)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("%s needs a world running the SafeZone game mode with authority"), CommandName);
+			OutPawnClass = nullptr;
+			return nullptr;
+		}
+
+		OutPawnClass = GameMode->GetPlayerCharacterClass();
+		return GameMode;
+	}
+
+	static void MakeRandomPositions(int32 Count, TArray<FVector>& OutPositions)
+	{
+		FRandomStream Stream(Count);
+		OutPositions.SetNumUninitialized(Count);
+		for (FVector& Position : OutPositions)
+		{
+			// Spread over twice the zone so roughly a fifth of the positions start inside
+			Position = FVector(Stream.FRandRange(-2.0f, 2.0f) * ZoneRadius, Stream.FRandRange(-2.0f, 2.0f) * ZoneRadius, 100.0f);
+		}
+	}
+
+	// Controllers for the benchmark characters, not registered with the game mode, so possession leaves the match untouched
+	static void SpawnBenchControllers(UWorld* World, int32 Count, TArray<AAIController*>& OutControllers)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		OutControllers.Reset(Count);
+		for (int32 Index = 0; Index < Count; ++Index)
+		{
+			OutControllers.Add(World->SpawnActor<AAIController>(AAIController::StaticClass(), SpawnParams));
+		}
+	}
+
+	// Where the benchmark character at Index spawns, on a grid outside the zone
+	static FTransform GetBenchCharacterTransform(int32 Index)
+	{
+		return FTransform(FVector(ZoneRadius * 4.0f + (Index % 10) * 200.0f, (Index / 10) * 200.0f, 1000.0f));
+	}
+
+	// Spawns a character of PawnClass for each controller and possesses it, null where the spawn failed
+	static void SpawnBenchCharacters(UWorld* World, UClass* PawnClass, const TArray<AAIController*>& Controllers, TArray<AGamePlayerCharacter*>& OutCharacters)
+	{
+		FActorSpawnParameters SpawnParams;
+		SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+		OutCharacters.SetNumZeroed(Controllers.Num());
+		for (int32 Index = 0; Index < Controllers.Num(); ++Index)
+		{
+			OutCharacters[Index] = World->SpawnActor<AGamePlayerCharacter>(PawnClass, GetBenchCharacterTransform(Index), SpawnParams);
+			if (Controllers[Index] && OutCharacters[Index])
+			{
+				Controllers[Index]->Possess(OutCharacters[Index]);
+			}
+		}
+	}
+
+	// Unpossesses and destroys the characters of SpawnBenchCharacters, the controllers stay for the next spawn
+	static void DestroyBenchCharacters(const TArray<AAIController*>& Controllers, TArray<AGamePlayerCharacter*>& Characters)
+	{
+		for (int32 Index = 0; Index < Characters.Num(); ++Index)
+		{
+			if (Characters[Index])
+			{
+				if (Controllers[Index])
+				{
+					Controllers[Index]->UnPossess();
+				}
+				Characters[Index]->Destroy();
+				Characters[Index] = nullptr;
+			}
+		}
+	}
+
+	static void DestroyBenchControllers(TArray<AAIController*>& Controllers)
+	{
+		for (AAIController* Controller : Controllers)
+		{
+			if (Controller)
+			{
+				Controller->Destroy();
+			}
+		}
+		Controllers.Reset();
+	}
+
+	// Private scheduler applying Damage every second to the characters with the zone damage effect of the match,
+	// the characters are only known to it
+	static void SetupBenchScheduler(FSafeZoneDamageScheduler& Scheduler, ASafeZoneGameMode* GameMode, float Damage, const TArray<AGamePlayerCharacter*>& Characters)
+	{
+		Scheduler.SetStepInterval(1.0f);
+		Scheduler.SetEffectClass(GameMode->GetZoneDamageScheduler().GetEffectClass());
+		Scheduler.PrebuildSpecs(Scheduler.GetEffectClass(), { Damage });
+		for (AGamePlayerCharacter* PlayerCharacter : Characters)
+		{
+			Scheduler.AddPlayer(PlayerCharacter);
+		}
+	}
+
+	// Forwards to the engine allocator and counts the allocations made on the game thread while it is GMalloc
+	class FCountingMalloc : public FMalloc
+	{
+	public:
+		FCountingMalloc()
+			: Inner(nullptr)
+			, NumAllocations(0)
+		{
+		}
+
+		// Installs the counter in front of the current GMalloc, Uninstall puts the engine allocator back
+		void Install()
+		{
+			check(IsInGameThread() && GMalloc != this);
+			NumAllocations = 0;
+			Inner = GMalloc;
+			GMalloc = this;
+		}
+
+		int32 Uninstall()
+		{
+			check(IsInGameThread() && GMalloc == this);
+			GMalloc = Inner;
+			// Inner stays set, other threads may still be inside a call that loaded the old GMalloc
+			return NumAllocations;
+		}
+
+		virtual void* Malloc(SIZE_T Size, uint32 Alignment) override
+		{
+			CountAllocation();
+			return Inner->Malloc(Size, Alignment);
+		}
+
+		virtual void* Realloc(void* Original, SIZE_T Size, uint32 Alignment) override
+		{
+			CountAllocation();
+			return Inner->Realloc(Original, Size, Alignment);
+		}
+
+		virtual void Free(void* Original) override
+		{
+			Inner->Free(Original);
+		}
+
+		virtual SIZE_T QuantizeSize(SIZE_T Size, uint32 Alignment) override
+		{
+			return Inner->QuantizeSize(Size, Alignment);
+		}
+
+		virtual bool GetAllocationSize(void* Original, SIZE_T& SizeOut) override
+		{
+			return Inner->GetAllocationSize(Original, SizeOut);
+		}
+
+		virtual void Trim(bool bTrimThreadCaches) override
+		{
+			Inner->Trim(bTrimThreadCaches);
+		}
+
+		virtual void SetupTLSCachesOnCurrentThread() override
+		{
+			Inner->SetupTLSCachesOnCurrentThread();
+		}
+
+		virtual void ClearAndDisableTLSCachesOnCurrentThread() override
+		{
+			Inner->ClearAndDisableTLSCachesOnCurrentThread();
+		}
+
+		virtual void UpdateStats() override
+		{
+			Inner->UpdateStats();
+		}
+
+		virtual void GetAllocatorStats(FGenericMemoryStats& OutStats) override
+		{
+			Inner->GetAllocatorStats(OutStats);
+		}
+
+		virtual void DumpAllocatorStats(FOutputDevice& Ar) override
+		{
+			Inner->DumpAllocatorStats(Ar);
+		}
+
+		virtual bool IsInternallyThreadSafe() const override
+		{
+			return Inner->IsInternallyThreadSafe();
+		}
+
+		virtual bool ValidateHeap() override
+		{
+			return Inner->ValidateHeap();
+		}
+
+		virtual const TCHAR* GetDescriptiveName() override
+		{
+			return TEXT("SafeZoneCountingMalloc");
+		}
+
+	private:
+		void CountAllocation()
+		{
+			if (IsInGameThread())
+			{
+				NumAllocations++;
+			}
+		}
+
+		FMalloc* Inner;
+
+		int32 NumAllocations;
+	};
+
+	// Static, so a thread that read GMalloc just before Uninstall never calls into a destroyed counter
+	static FCountingMalloc CountingMalloc;
+
+	static USphereComponent* SpawnOverlapSphere(UWorld* World, const FVector& Location, float Radius, TArray<AActor*>& SpawnedActors)
+	{
+		AActor* Owner = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform(Location));
+		USphereComponent* Sphere = NewObject<USphereComponent>(Owner);
+		Sphere->InitSphereRadius(Radius);
+		Sphere->SetCollisionObjectType(ECC_WorldDynamic);
+		Sphere->SetCollisionEnabled(ECollisionEnabled::QueryOnly);
+		Sphere->SetCollisionResponseToAllChannels(ECR_Ignore);
+		Sphere->SetCollisionResponseToChannel(ECC_Pawn, ECR_Overlap);
+		Sphere->SetGenerateOverlapEvents(true);
+		Owner->SetRootComponent(Sphere);
+		Sphere->RegisterComponent();
+		Sphere->SetWorldLocation(Location);
+		SpawnedActors.Add(Owner);
+		return Sphere;
+	}
+
+	static void SpawnOverlapCapsule(UWorld* World, const FVector& Location, TArray<AActor*>& SpawnedActors)
+	{
+		AActor* Owner = World->SpawnActor<AActor>(AActor::StaticClass(), FTransform(Location));
+		UCapsuleComponent* Capsule = NewObject<UCapsuleComponent>(Owner);
+		Capsule->InitCapsuleSize(42.0f, 96.0f);
+		Capsule->SetCollisionProfileName(UCollisionProfile::Pawn_ProfileName);
+		Capsule->SetGenerateOverlapEvents(true);
+		Owner->SetRootComponent(Capsule);
+		Capsule->RegisterComponent();
+		Capsule->SetWorldLocation(Location);
+		SpawnedActors.Add(Owner);
+	}
+
+	static void QuadrantCircle(int32 QuadrantIndex, float Radius, FVector2D& OutCenter, float& OutRadius)
+	{
+		const float Angle = FMath::DegreesToRadians(90.0f * QuadrantIndex);
+		OutRadius = Radius / 2.0f;
+		OutCenter = FVector2D(FMath::Cos(Angle), FMath::Sin(Angle)) * OutRadius;
+	}
+
+	// SafeZone.Bench.Membership [Count...]
+	// Compares the batched membership kernel with overlap events from resized zone and quadrant spheres.
+	static void BenchMembership(const TArray<FString>& Args, UWorld* World)
+	{
+		if (!World)
+		{
+			return;
+		}
+
+		const int32 Passes = 50;
+		const TArray<int32> Counts = ParseCounts(Args, { 100, 1000, 10000 });
+
+		for (const int32 Count : Counts)
+		{
+			TArray<FVector> Positions;
+			MakeRandomPositions(Count, Positions);
+
+			// Kernel path as the game mode runs it: gather, test the zone and its exit hysteresis circle in one
+			// pass, keep or change each inside state from the masks and fill the four quadrants
+			FSafeZoneMembershipBatch Batch;
+			TArray<FVector2D> Centers = { FVector2D::ZeroVector, FVector2D::ZeroVector };
+			TArray<float> Radii = { 0.0f, 0.0f };
+			TArray<uint32> Masks;
+			TArray<uint8> QuadrantFlags;
+			TArray<uint8> InsideState;
+			InsideState.Init(1, Count);
+			int32 KernelInside = 0;
+
+			const double KernelStart = FPlatformTime::Seconds();
+			for (int32 Pass = 0; Pass < Passes; ++Pass)
+			{
+				const float Radius = ZoneRadius * (1.0f - 0.01f * Pass);
+
+				Batch.Reset();
+				for (int32 Index = 0; Index < Count; ++Index)
+				{
+					Batch.Add(Positions[Index]);
+				}
+
+				Radii[0] = Radius;
+				Radii[1] = Radius + ZoneExitHysteresis;
+				Batch.TestCircles(Centers, Radii, Masks);
+
+				for (int32 QuadrantIndex = 0; QuadrantIndex < 4; ++QuadrantIndex)
+				{
+					FVector2D QuadrantCenter;
+					float QuadrantRadius;
+					QuadrantCircle(QuadrantIndex, Radius, QuadrantCenter, QuadrantRadius);
+					Batch.TestCircle(QuadrantCenter, QuadrantRadius, QuadrantFlags);
+				}
+
+				// Inside players stay until they leave the hysteresis circle, outside players enter through the zone circle
+				KernelInside = 0;
+				for (int32 Index = 0; Index < Count; ++Index)
+				{
+					InsideState[Index] = (Masks[Index] & (InsideState[Index] ? 2u : 1u)) != 0 ? 1 : 0;
+					KernelInside += InsideState[Index];
+				}
+			}
+			const double KernelSeconds = (FPlatformTime::Seconds() - KernelStart) / Passes;
+
+			// Overlap path: one capsule per position, zone and quadrant spheres resized every pass
+			TArray<AActor*> SpawnedActors;
+			for (const FVector& Position : Positions)
+			{
+				SpawnOverlapCapsule(World, Position, SpawnedActors);
+			}
+
+			USphereComponent* ZoneSphere = SpawnOverlapSphere(World, FVector(0.0f, 0.0f, 100.0f), ZoneRadius, SpawnedActors);
+			TArray<USphereComponent*> QuadrantSpheres;
+			for (int32 QuadrantIndex = 0; QuadrantIndex < 4; ++QuadrantIndex)
+			{
+				FVector2D QuadrantCenter;
+				float QuadrantRadius;
+				QuadrantCircle(QuadrantIndex, ZoneRadius, QuadrantCenter, QuadrantRadius);
+				QuadrantSpheres.Add(SpawnOverlapSphere(World, FVector(QuadrantCenter, 100.0f), QuadrantRadius, SpawnedActors));
+			}
+
+			TArray<AActor*> OverlappingActors;
+			int32 OverlapInside = 0;
+
+			const double OverlapStart = FPlatformTime::Seconds();
+			for (int32 Pass = 0; Pass < Passes; ++Pass)
+			{
+				const float Radius = ZoneRadius * (1.0f - 0.01f * Pass);
+
+				ZoneSphere->SetSphereRadius(Radius);
+				for (int32 QuadrantIndex = 0; QuadrantIndex < 4; ++QuadrantIndex)
+				{
+					FVector2D QuadrantCenter;
+					float QuadrantRadius;
+					QuadrantCircle(QuadrantIndex, Radius, QuadrantCenter, QuadrantRadius);
+					QuadrantSpheres[QuadrantIndex]->SetWorldLocation(FVector(QuadrantCenter, 100.0f));
+					QuadrantSpheres[QuadrantIndex]->SetSphereRadius(QuadrantRadius);
+				}
+
+				ZoneSphere->GetOverlappingActors(OverlappingActors);
+				OverlapInside = OverlappingActors.Num();
+			}
+			const double OverlapSeconds = (FPlatformTime::Seconds() - OverlapStart) / Passes;
+
+			for (AActor* Actor : SpawnedActors)
+			{
+				Actor->Destroy();
+			}
+
+			UE_LOG(LogTemp, Display, TEXT("SafeZone membership %6d positions: kernel %8.3f ms/pass (%d inside), overlap %8.3f ms/pass (%d inside), %.1fx"),
+				Count, KernelSeconds * 1000.0, KernelInside, OverlapSeconds * 1000.0, OverlapInside, KernelSeconds > 0.0 ? OverlapSeconds / KernelSeconds : 0.0);
+		}
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs BenchMembershipCommand(
+		TEXT("SafeZone.Bench.Membership"),
+		TEXT("Compares the batched zone membership kernel with the overlap path. Usage: SafeZone.Bench.Membership [Count...]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&BenchMembership));
+
+	// SafeZone.Bench.CharacterPool [Count...]
+	// Respawns Count possessed characters through spawn/destroy and through a character pool.
+	static void BenchCharacterPool(const TArray<FString>& Args, UWorld* World)
+	{
+		UClass* PawnClass = nullptr;
+		ASafeZoneGameMode* GameMode = GetGameModeAndPawnClass(World, TEXT("SafeZone.Bench.CharacterPool"), PawnClass);
+		if (!GameMode)
+		{
+			return;
+		}
+
+		const int32 Rounds = 5;
+		const TArray<int32> Counts = ParseCounts(Args, { 100 });
+
+		for (const int32 Count : Counts)
+		{
+			TArray<AAIController*> Controllers;
+			SpawnBenchControllers(World, Count, Controllers);
+
+			TArray<AGamePlayerCharacter*> Characters;
+			Characters.SetNumZeroed(Count);
+
+			// Spawn path: construction, full attribute and ability setup, destroy and garbage collection
+			double SpawnSeconds = 0.0;
+			double DestroySeconds = 0.0;
+			for (int32 Round = 0; Round < Rounds; ++Round)
+			{
+				double Start = FPlatformTime::Seconds();
+				SpawnBenchCharacters(World, PawnClass, Controllers, Characters);
+				SpawnSeconds += FPlatformTime::Seconds() - Start;
+
+				Start = FPlatformTime::Seconds();
+				DestroyBenchCharacters(Controllers, Characters);
+				DestroySeconds += FPlatformTime::Seconds() - Start;
+			}
+
+			const double GcStart = FPlatformTime::Seconds();
+			CollectGarbage(GARBAGE_COLLECTION_KEEPFLAGS);
+			const double GcSeconds = FPlatformTime::Seconds() - GcStart;
+
+			// Pool path, a private pool so the match pool is untouched. The untimed first round does the full setup once
+			FSafeZoneCharacterPool Pool;
+			Pool.Prewarm(World, PawnClass, Count);
+
+			double AcquireSeconds = 0.0;
+			double ReleaseSeconds = 0.0;
+			for (int32 Round = 0; Round <= Rounds; ++Round)
+			{
+				double Start = FPlatformTime::Seconds();
+				for (int32 Index = 0; Index < Count; ++Index)
+				{
+					Characters[Index] = Pool.Acquire(PawnClass, GetBenchCharacterTransform(Index));
+					if (Controllers[Index] && Characters[Index])
+					{
+						Controllers[Index]->Possess(Characters[Index]);
+					}
+				}
+				const double AcquireRoundSeconds = FPlatformTime::Seconds() - Start;
+
+				Start = FPlatformTime::Seconds();
+				for (int32 Index = 0; Index < Count; ++Index)
+				{
+					if (Characters[Index])
+					{
+						if (Controllers[Index])
+						{
+							Controllers[Index]->UnPossess();
+						}
+						Pool.Release(Characters[Index]);
+						Characters[Index] = nullptr;
+					}
+				}
+				const double ReleaseRoundSeconds = FPlatformTime::Seconds() - Start;
+
+				if (Round > 0)
+				{
+					AcquireSeconds += AcquireRoundSeconds;
+					ReleaseSeconds += ReleaseRoundSeconds;
+				}
+			}
+
+			Pool.Reset();
+			DestroyBenchControllers(Controllers);
+
+			const double SpawnPathMs = (SpawnSeconds + DestroySeconds) * 1000.0 / Rounds;
+			const double PoolPathMs = (AcquireSeconds + ReleaseSeconds) * 1000.0 / Rounds;
+			UE_LOG(LogTemp, Display, TEXT("SafeZone character pool %4d characters: spawn %8.3f ms + destroy %8.3f ms per round (+%.3f ms gc for %d rounds), pooled acquire %8.3f ms + release %8.3f ms per round, %.1fx"),
+				Count, SpawnSeconds * 1000.0 / Rounds, DestroySeconds * 1000.0 / Rounds, GcSeconds * 1000.0, Rounds,
+				AcquireSeconds * 1000.0 / Rounds, ReleaseSeconds * 1000.0 / Rounds, PoolPathMs > 0.0 ? SpawnPathMs / PoolPathMs : 0.0);
+		}
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs BenchCharacterPoolCommand(
+		TEXT("SafeZone.Bench.CharacterPool"),
+		TEXT("Compares spawn/destroy respawns with pooled in place respawns. Usage: SafeZone.Bench.CharacterPool [Count...]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&BenchCharacterPool));
+
+	// SafeZone.Bench.MatchReset [reload]
+	// Resets the running match in place, or with "reload" restarts the level, and logs how long it took.
+	static void BenchMatchReset(const TArray<FString>& Args, UWorld* World)
+	{
+		UClass* PawnClass = nullptr;
+		ASafeZoneGameMode* GameMode = GetGameModeAndPawnClass(World, TEXT("SafeZone.Bench.MatchReset"), PawnClass);
+		if (!GameMode)
+		{
+			return;
+		}
+
+		if (Args.Num() > 0 && Args[0] == TEXT("reload"))
+		{
+			// Logged by the BeginPlay of the next game mode
+			ASafeZoneGameMode::MarkLevelReloadStart();
+			World->ServerTravel(TEXT("?Restart"));
+			return;
+		}
+
+		GameMode->ResetMatch();
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs BenchMatchResetCommand(
+		TEXT("SafeZone.Bench.MatchReset"),
+		TEXT("Times an in place match reset, or a full level reload with the reload argument. Usage: SafeZone.Bench.MatchReset [reload]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&BenchMatchReset));
+
+	// SafeZone.Bench.DamageAllocations [Count...]
+	// Runs zone damage passes over Count characters through the damage effect and directly, counting game thread heap allocations.
+	static void BenchDamageAllocations(const TArray<FString>& Args, UWorld* World)
+	{
+		UClass* PawnClass = nullptr;
+		ASafeZoneGameMode* GameMode = GetGameModeAndPawnClass(World, TEXT("SafeZone.Bench.DamageAllocations"), PawnClass);
+		if (!GameMode)
+		{
+			return;
+		}
+
+		// Small enough that nobody gets knocked down over all passes
+		const float Damage = 0.001f;
+		const int32 Passes = 20;
+		const TArray<int32> Counts = ParseCounts(Args, { 100 });
+
+		for (const int32 Count : Counts)
+		{
+			TArray<AAIController*> Controllers;
+			TArray<AGamePlayerCharacter*> Characters;
+			SpawnBenchControllers(World, Count, Controllers);
+			SpawnBenchCharacters(World, PawnClass, Controllers, Characters);
+
+			FSafeZoneDamageScheduler Scheduler;
+			SetupBenchScheduler(Scheduler, GameMode, Damage, Characters);
+
+			for (const bool bDirect : { false, true })
+			{
+				Scheduler.SetApplyDirectly(bDirect);
+
+				// The untimed first pass settles any lazily grown engine state
+				Scheduler.Advance(1.0f, Damage);
+
+				int32 Applications = 0;
+				const double Start = FPlatformTime::Seconds();
+				CountingMalloc.Install();
+				for (int32 Pass = 0; Pass < Passes; ++Pass)
+				{
+					Applications += Scheduler.Advance(1.0f, Damage);
+				}
+				const int32 Allocations = CountingMalloc.Uninstall();
+				const double Seconds = FPlatformTime::Seconds() - Start;
+
+				UE_LOG(LogTemp, Display, TEXT("SafeZone damage %4d characters, %s: %8.3f ms/pass, %7.1f allocations/pass, %6.2f allocations/application"),
+					Count, bDirect ? TEXT("direct        ") : TEXT("gameplay effect"), Seconds * 1000.0 / Passes, (float)Allocations / Passes,
+					Applications > 0 ? (float)Allocations / Applications : 0.0f);
+			}
+
+			DestroyBenchCharacters(Controllers, Characters);
+			DestroyBenchControllers(Controllers);
+		}
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs BenchDamageAllocationsCommand(
+		TEXT("SafeZone.Bench.DamageAllocations"),
+		TEXT("Counts heap allocations per zone damage pass, through the damage effect and applied directly. Usage: SafeZone.Bench.DamageAllocations [Count...]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&BenchDamageAllocations));
+
+	// Executions per second of a damage execution class on a zone damage spec against the target's ability system component
+	static double MeasureDamageExecutions(TSubclassOf<UGameplayEffectExecutionCalculation> ExecutionClass, UAbilitySystemComponent* Target, float Damage, int32 Iterations, float& OutDamage)
+	{
+		// Transient instant effect with only this execution, so the spec sets up exactly its captures
+		UGameplayEffect* Effect = NewObject<UGameplayEffect>(GetTransientPackage(), NAME_None, RF_Transient);
+		Effect->DurationPolicy = EGameplayEffectDurationType::Instant;
+		FGameplayEffectExecutionDefinition& Execution = Effect->Executions.AddDefaulted_GetRef();
+		Execution.CalculationClass = ExecutionClass;
+
+		FGameplayEffectContextHandle Context(UAbilitySystemGlobals::Get().AllocGameplayEffectContext());
+		FGameplayEffectSpec Spec(Effect, Context, 1.0f);
+		Spec.SetSetByCallerMagnitude(FSafeZoneGameplayTags::Get().Data_Damage, Damage);
+		Spec.CaptureAttributeDataFromTarget(Target);
+
+		const TArray<FGameplayEffectExecutionScopedModifierInfo> ScopedModifiers;
+		const FGameplayEffectCustomExecutionParameters Params(Spec, ScopedModifiers, Target, FGameplayTagContainer(), FPredictionKey());
+		const UGameplayEffectExecutionCalculation* Calculation = ExecutionClass->GetDefaultObject<UGameplayEffectExecutionCalculation>();
+
+		OutDamage = 0.0f;
+		const double Start = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < Iterations; ++Index)
+		{
+			FGameplayEffectCustomExecutionOutput Output;
+			Calculation->Execute_Implementation(Params, Output);
+			for (const FGameplayModifierEvaluatedData& Modifier : Output.GetOutputModifiersRef())
+			{
+				OutDamage += Modifier.Magnitude;
+			}
+		}
+		const double Seconds = FPlatformTime::Seconds() - Start;
+
+		return Seconds > 0.0 ? Iterations / Seconds : 0.0;
+	}
+
+	// SafeZone.Bench.DamageExecution [Iterations]
+	// Runs the damage execution of the current damage effect and the zone damage executions on one character's ability system component.
+	static void BenchDamageExecution(const TArray<FString>& Args, UWorld* World)
+	{
+		UClass* PawnClass = nullptr;
+		ASafeZoneGameMode* GameMode = GetGameModeAndPawnClass(World, TEXT("SafeZone.Bench.DamageExecution"), PawnClass);
+		if (!GameMode)
+		{
+			return;
+		}
+
+		// Unregistered controller, so the character gets its attributes right away and stays out of the match
+		TArray<AAIController*> Controllers;
+		TArray<AGamePlayerCharacter*> Characters;
+		SpawnBenchControllers(World, 1, Controllers);
+		SpawnBenchCharacters(World, PawnClass, Controllers, Characters);
+
+		UAbilitySystemComponent* AbilitySystemComponent = Characters[0] ? Characters[0]->GetAbilitySystemComponent() : nullptr;
+		if (Controllers[0] && AbilitySystemComponent)
+		{
+			const int32 Iterations = ParseCounts(Args, { 100000 })[0];
+			const float Damage = 5.0f;
+
+			float CurrentDamage = 0.0f;
+			float ZoneDamage = 0.0f;
+			float ResistDamage = 0.0f;
+			const double CurrentRate = MeasureDamageExecutions(UDamageGE_ExecutionCalculation::StaticClass(), AbilitySystemComponent, Damage, Iterations, CurrentDamage);
+			const double ZoneRate = MeasureDamageExecutions(UZoneDamageGE_ExecutionCalculation::StaticClass(), AbilitySystemComponent, Damage, Iterations, ZoneDamage);
+			const double ResistRate = MeasureDamageExecutions(UZoneDamageResistGE_ExecutionCalculation::StaticClass(), AbilitySystemComponent, Damage, Iterations, ResistDamage);
+
+			UE_LOG(LogTemp, Display, TEXT("SafeZone damage execution %d runs: current %10.0f/s, zone %10.0f/s (%.1fx), zone with resistance %10.0f/s (%.1fx), damage %.0f/%.0f/%.0f"),
+				Iterations, CurrentRate, ZoneRate, CurrentRate > 0.0 ? ZoneRate / CurrentRate : 0.0, ResistRate, CurrentRate > 0.0 ? ResistRate / CurrentRate : 0.0,
+				CurrentDamage, ZoneDamage, ResistDamage);
+		}
+
+		DestroyBenchCharacters(Controllers, Characters);
+		DestroyBenchControllers(Controllers);
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs BenchDamageExecutionCommand(
+		TEXT("SafeZone.Bench.DamageExecution"),
+		TEXT("Compares executions per second of the damage execution with the zone damage executions. Usage: SafeZone.Bench.DamageExecution [Iterations]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&BenchDamageExecution));
+
+	// SafeZone.Bench.AttributeChanges [Count...]
+	// Applies a health regen tick and a zone damage tick to Count characters and logs the attribute changes per second.
+	static void BenchAttributeChanges(const TArray<FString>& Args, UWorld* World)
+	{
+		UClass* PawnClass = nullptr;
+		ASafeZoneGameMode* GameMode = GetGameModeAndPawnClass(World, TEXT("SafeZone.Bench.AttributeChanges"), PawnClass);
+		if (!GameMode)
+		{
+			return;
+		}
+
+		const int32 Rounds = 50;
+		const TArray<int32> Counts = ParseCounts(Args, { 100 });
+
+		// Instant health regen, goes through the health branch of PostGameplayEffectExecute
+		UGameplayEffect* RegenEffect = NewObject<UGameplayEffect>(GetTransientPackage(), NAME_None, RF_Transient);
+		RegenEffect->DurationPolicy = EGameplayEffectDurationType::Instant;
+		FGameplayModifierInfo& RegenModifier = RegenEffect->Modifiers.AddDefaulted_GetRef();
+		RegenModifier.Attribute = UPlayerAttributeSet::GetHealthAttribute();
+		RegenModifier.ModifierOp = EGameplayModOp::Additive;
+		RegenModifier.ModifierMagnitude = FScalableFloat(0.001f);
+
+		FGameplayEffectContextHandle Context(UAbilitySystemGlobals::Get().AllocGameplayEffectContext());
+		const FGameplayEffectSpec RegenSpec(RegenEffect, Context, 1.0f);
+
+		for (const int32 Count : Counts)
+		{
+			TArray<AAIController*> Controllers;
+			TArray<AGamePlayerCharacter*> Characters;
+			SpawnBenchControllers(World, Count, Controllers);
+			SpawnBenchCharacters(World, PawnClass, Controllers, Characters);
+
+			TArray<UAbilitySystemComponent*> Targets;
+			TArray<AGamePlayerCharacter*> TargetCharacters;
+			for (int32 Index = 0; Index < Count; ++Index)
+			{
+				UAbilitySystemComponent* AbilitySystemComponent = Characters[Index] ? Characters[Index]->GetAbilitySystemComponent() : nullptr;
+				if (Controllers[Index] && AbilitySystemComponent)
+				{
+					Targets.Add(AbilitySystemComponent);
+					TargetCharacters.Add(Characters[Index]);
+				}
+			}
+
+			// Zone damage through the zone damage effect, small enough that nobody gets knocked down over all rounds
+			const float Damage = 0.001f;
+			FSafeZoneDamageScheduler Scheduler;
+			SetupBenchScheduler(Scheduler, GameMode, Damage, TargetCharacters);
+
+			double RegenSeconds = 0.0;
+			double DamageSeconds = 0.0;
+			for (int32 Round = 0; Round < Rounds; ++Round)
+			{
+				double Start = FPlatformTime::Seconds();
+				for (UAbilitySystemComponent* Target : Targets)
+				{
+					Target->ApplyGameplayEffectSpecToSelf(RegenSpec);
+				}
+				RegenSeconds += FPlatformTime::Seconds() - Start;
+
+				Start = FPlatformTime::Seconds();
+				Scheduler.Advance(1.0f, Damage);
+				DamageSeconds += FPlatformTime::Seconds() - Start;
+			}
+
+			const int32 Applications = Targets.Num() * Rounds;
+			UE_LOG(LogTemp, Display, TEXT("SafeZone attribute changes %4d targets: regen %10.0f/s (%8.0f/s per target), zone damage %10.0f/s (%8.0f/s per target)"),
+				Targets.Num(),
+				RegenSeconds > 0.0 ? Applications / RegenSeconds : 0.0, RegenSeconds > 0.0 && Targets.Num() > 0 ? Rounds / RegenSeconds : 0.0,
+				DamageSeconds > 0.0 ? Applications / DamageSeconds : 0.0, DamageSeconds > 0.0 && Targets.Num() > 0 ? Rounds / DamageSeconds : 0.0);
+
+			DestroyBenchCharacters(Controllers, Characters);
+			DestroyBenchControllers(Controllers);
+		}
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs BenchAttributeChangesCommand(
+		TEXT("SafeZone.Bench.AttributeChanges"),
+		TEXT("Logs attribute change throughput through PostGameplayEffectExecute for regen and zone damage ticks. Usage: SafeZone.Bench.AttributeChanges [Count...]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&BenchAttributeChanges));
+
+	// SafeZone.Bench.GameplayTags [Iterations]
+	// Times the Data.Damage lookup of the damage path by name and from the native tag table, alone and as the SetByCaller read.
+	static void BenchGameplayTags(const TArray<FString>& Args)
+	{
+		const int32 Iterations = ParseCounts(Args, { 1000000 })[0];
+
+		FGameplayEffectContextHandle Context(UAbilitySystemGlobals::Get().AllocGameplayEffectContext());
+		FGameplayEffectSpec Spec(GetDefault<UGameplayEffect>(), Context, 1.0f);
+		Spec.SetSetByCallerMagnitude(FSafeZoneGameplayTags::Get().Data_Damage, 1.0f);
+
+		// Summed so the loops can't be optimized away
+		int32 ValidTags = 0;
+		float Magnitude = 0.0f;
+
+		double Start = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < Iterations; ++Index)
+		{
+			ValidTags += FGameplayTag::RequestGameplayTag(FName("Data.Damage")).IsValid() ? 1 : 0;
+		}
+		const double RequestSeconds = FPlatformTime::Seconds() - Start;
+
+		Start = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < Iterations; ++Index)
+		{
+			ValidTags += FSafeZoneGameplayTags::Get().Data_Damage.IsValid() ? 1 : 0;
+		}
+		const double NativeSeconds = FPlatformTime::Seconds() - Start;
+
+		Start = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < Iterations; ++Index)
+		{
+			Magnitude += Spec.GetSetByCallerMagnitude(FGameplayTag::RequestGameplayTag(FName("Data.Damage")), false, -1.0f);
+		}
+		const double RequestMagnitudeSeconds = FPlatformTime::Seconds() - Start;
+
+		Start = FPlatformTime::Seconds();
+		for (int32 Index = 0; Index < Iterations; ++Index)
+		{
+			Magnitude += Spec.GetSetByCallerMagnitude(FSafeZoneGameplayTags::Get().Data_Damage, false, -1.0f);
+		}
+		const double NativeMagnitudeSeconds = FPlatformTime::Seconds() - Start;
+
+		const double ToNs = 1.0e9 / Iterations;
+		UE_LOG(LogTemp, Display, TEXT("SafeZone gameplay tags %d calls: tag by name %7.2f ns, native %7.2f ns, saving %7.2f ns/call"),
+			Iterations, RequestSeconds * ToNs, NativeSeconds * ToNs, (RequestSeconds - NativeSeconds) * ToNs);
+		UE_LOG(LogTemp, Display, TEXT("SafeZone gameplay tags %d calls: SetByCaller read by name %7.2f ns, native %7.2f ns, saving %7.2f ns/call (%d, %.0f)"),
+			Iterations, RequestMagnitudeSeconds * ToNs, NativeMagnitudeSeconds * ToNs, (RequestMagnitudeSeconds - NativeMagnitudeSeconds) * ToNs, ValidTags, Magnitude);
+	}
+
+	static FAutoConsoleCommandWithArgs BenchGameplayTagsCommand(
+		TEXT("SafeZone.Bench.GameplayTags"),
+		TEXT("Compares gameplay tag lookups by name with the native tag table on the damage path. Usage: SafeZone.Bench.GameplayTags [Iterations]"),
+		FConsoleCommandWithArgsDelegate::CreateStatic(&BenchGameplayTags));
+
+	// SafeZone.Bench.NetBandwidth [Seconds] [Full|Mixed|Minimal]
+	// Switches every character's ability system to the replication mode, then logs the bytes sent to each client over the window.
+	static void BenchNetBandwidth(const TArray<FString>& Args, UWorld* World)
+	{
+		UNetDriver* NetDriver = World ? World->GetNetDriver() : nullptr;
+		if (!NetDriver || !NetDriver->IsServer() || NetDriver->ClientConnections.Num() == 0)
+		{
+			UE_LOG(LogTemp, Warning, TEXT("SafeZone.Bench.NetBandwidth needs a listen or dedicated server with connected clients"));
+			return;
+		}
+
+		const float Seconds = Args.Num() > 0 ? FMath::Max(FCString::Atof(*Args[0]), 1.0f) : 10.0f;
+
+		EGameplayEffectReplicationMode Mode = EGameplayEffectReplicationMode::Mixed;
+		if (Args.Num() > 1)
+		{
+			if (Args[1] == TEXT("Full"))
+			{
+				Mode = EGameplayEffectReplicationMode::Full;
+			}
+			else if (Args[1] == TEXT("Minimal"))
+			{
+				Mode = EGameplayEffectReplicationMode::Minimal;
+			}
+		}
+
+		int32 NumCharacters = 0;
+		for (TActorIterator<AGamePlayerCharacter> It(World); It; ++It)
+		{
+			if (UAbilitySystemComponent* AbilitySystemComponent = It->GetAbilitySystemComponent())
+			{
+				AbilitySystemComponent->SetReplicationMode(Mode);
+				NumCharacters++;
+			}
+		}
+
+		TMap<TWeakObjectPtr<UNetConnection>, uint32> StartBytes;
+		for (UNetConnection* Connection : NetDriver->ClientConnections)
+		{
+			StartBytes.Add(Connection, Connection->OutTotalBytes);
+		}
+
+		const FString ModeName = Args.Num() > 1 ? Args[1] : FString(TEXT("Mixed"));
+		const double StartTime = FPlatformTime::Seconds();
+		TWeakObjectPtr<UWorld> WeakWorld(World);
+
+		FTimerHandle TimerHandle;
+		World->GetTimerManager().SetTimer(TimerHandle, FTimerDelegate::CreateLambda([WeakWorld, StartBytes, StartTime, ModeName, NumCharacters]()
+		{
+			UWorld* LiveWorld = WeakWorld.Get();
+			if (!LiveWorld)
+			{
+				return;
+			}
+
+			const double Elapsed = FPlatformTime::Seconds() - StartTime;
+			uint64 TotalBytes = 0;
+			int32 NumConnections = 0;
+			for (const TPair<TWeakObjectPtr<UNetConnection>, uint32>& Pair : StartBytes)
+			{
+				if (UNetConnection* Connection = Pair.Key.Get())
+				{
+					const uint32 Bytes = Connection->OutTotalBytes - Pair.Value;
+					UE_LOG(LogTemp, Display, TEXT("SafeZone net bandwidth %s: %8.1f bytes/s to %s"), *ModeName, Bytes / Elapsed, *Connection->LowLevelGetRemoteAddress());
+					TotalBytes += Bytes;
+					NumConnections++;
+				}
+			}
+
+			UE_LOG(LogTemp, Display, TEXT("SafeZone net bandwidth %s: %d characters, %d clients, %8.1f bytes/s per client over %.1f s"),
+				*ModeName, NumCharacters, NumConnections, NumConnections > 0 ? TotalBytes / Elapsed / NumConnections : 0.0, Elapsed);
+
+			// Back to the mode the characters are created with
+			for (TActorIterator<AGamePlayerCharacter> It(LiveWorld); It; ++It)
+			{
+				if (UAbilitySystemComponent* AbilitySystemComponent = It->GetAbilitySystemComponent())
+				{
+					AbilitySystemComponent->SetReplicationMode(EGameplayEffectReplicationMode::Mixed);
+				}
+			}
+		}), Seconds, false);
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs BenchNetBandwidthCommand(
+		TEXT("SafeZone.Bench.NetBandwidth"),
+		TEXT("Logs the bytes sent to each client with the characters' ability systems in the given replication mode. Usage: SafeZone.Bench.NetBandwidth [Seconds] [Full|Mixed|Minimal]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&BenchNetBandwidth));
+
+	// SafeZone.Bench.AbilityInstances [verbose]
+	// Logs the ability objects the characters hold and their memory per ability class, with verbose also per character.
+	static void BenchAbilityInstances(const TArray<FString>& Args, UWorld* World)
+	{
+		if (!World)
+		{
+			return;
+		}
+
+		const bool bVerbose = Args.Num() > 0 && Args[0] == TEXT("verbose");
+
+		struct FAbilityClassUsage
+		{
+			EGameplayAbilityInstancingPolicy::Type Policy = EGameplayAbilityInstancingPolicy::InstancedPerActor;
+			int32 NumSpecs = 0;
+			int32 NumInstances = 0;
+			SIZE_T Bytes = 0;
+		};
+
+		TMap<UClass*, FAbilityClassUsage> Usages;
+		int32 NumCharacters = 0;
+		int32 TotalInstances = 0;
+		SIZE_T TotalBytes = 0;
+
+		for (TActorIterator<AGamePlayerCharacter> It(World); It; ++It)
+		{
+			UAbilitySystemComponent* AbilitySystemComponent = It->GetAbilitySystemComponent();
+			if (!AbilitySystemComponent)
+			{
+				continue;
+			}
+
+			int32 NumSpecs = 0;
+			int32 NumInstances = 0;
+			SIZE_T Bytes = 0;
+			for (const FGameplayAbilitySpec& Spec : AbilitySystemComponent->GetActivatableAbilities())
+			{
+				if (!Spec.Ability)
+				{
+					continue;
+				}
+
+				FAbilityClassUsage& Usage = Usages.FindOrAdd(Spec.Ability->GetClass());
+				Usage.Policy = Spec.Ability->GetInstancingPolicy();
+				Usage.NumSpecs++;
+				NumSpecs++;
+
+				for (UGameplayAbility* Instance : Spec.GetAbilityInstances())
+				{
+					// The object itself plus what its containers allocated
+					FArchiveCountMem Count(Instance);
+					const SIZE_T InstanceBytes = Instance->GetClass()->GetStructureSize() + Count.GetMax();
+					Usage.NumInstances++;
+					Usage.Bytes += InstanceBytes;
+					NumInstances++;
+					Bytes += InstanceBytes;
+				}
+			}
+
+			if (bVerbose)
+			{
+				UE_LOG(LogTemp, Display, TEXT("SafeZone abilities %s: %d granted, %d instances, %llu bytes"), *It->GetName(), NumSpecs, NumInstances, (uint64)Bytes);
+			}
+
+			NumCharacters++;
+			TotalInstances += NumInstances;
+			TotalBytes += Bytes;
+		}
+
+		static const TCHAR* PolicyNames[] = { TEXT("NonInstanced"), TEXT("InstancedPerActor"), TEXT("InstancedPerExecution") };
+		for (const TPair<UClass*, FAbilityClassUsage>& Pair : Usages)
+		{
+			const FAbilityClassUsage& Usage = Pair.Value;
+			UE_LOG(LogTemp, Display, TEXT("SafeZone abilities %s (%s): granted %d times, %d instances, %llu bytes"),
+				*Pair.Key->GetName(), PolicyNames[FMath::Clamp<int32>(Usage.Policy, 0, UE_ARRAY_COUNT(PolicyNames) - 1)], Usage.NumSpecs, Usage.NumInstances, (uint64)Usage.Bytes);
+		}
+
+		// Every live ability instance, including the ones of ended executions not collected yet
+		int32 NumLiveInstances = 0;
+		for (TObjectIterator<UGameplayAbility> It; It; ++It)
+		{
+			if (!It->HasAnyFlags(RF_ClassDefaultObject | RF_ArchetypeObject))
+			{
+				NumLiveInstances++;
+			}
+		}
+
+		UE_LOG(LogTemp, Display, TEXT("SafeZone abilities: %d characters, %d instances (%.1f per character), %llu bytes (%.0f per character), %d ability objects alive"),
+			NumCharacters, TotalInstances, NumCharacters > 0 ? (float)TotalInstances / NumCharacters : 0.0f,
+			(uint64)TotalBytes, NumCharacters > 0 ? (double)TotalBytes / NumCharacters : 0.0, NumLiveInstances);
+	}
+
+	static FAutoConsoleCommandWithWorldAndArgs BenchAbilityInstancesCommand(
+		TEXT("SafeZone.Bench.AbilityInstances"),
+		TEXT("Logs the ability instances held by the characters and their memory per ability class. Usage: SafeZone.Bench.AbilityInstances [verbose]"),
+		FConsoleCommandWithWorldAndArgsDelegate::CreateStatic(&BenchAbilityInstances));
+}
+
+#endif // !UE_BUILD_SHIPPING
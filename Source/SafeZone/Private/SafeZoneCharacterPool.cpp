@@ -0,0 +1,67 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SafeZoneCharacterPool.h"
+#include "Engine/World.h"
+#include "GamePlayerCharacter.h"
+
+AGamePlayerCharacter* FSafeZoneCharacterPool::Acquire(TSubclassOf<AGamePlayerCharacter> CharacterClass, const FTransform& SpawnTransform)
+{
+	for (int32 Index = Available.Num() - 1; Index >= 0; --Index)
+	{
+		AGamePlayerCharacter* PlayerCharacter = Available[Index].Get();
+		if (!IsValid(PlayerCharacter))
+		{
+			Available.RemoveAtSwap(Index, 1, false);
+			continue;
+		}
+
+		if (PlayerCharacter->GetClass() == CharacterClass)
+		{
+			Available.RemoveAtSwap(Index, 1, false);
+			PlayerCharacter->ActivateFromPool(SpawnTransform);
+			return PlayerCharacter;
+		}
+	}
+
+	return nullptr;
+}
+
+void FSafeZoneCharacterPool::Release(AGamePlayerCharacter* PlayerCharacter)
+{
+	if (!IsValid(PlayerCharacter))
+	{
+		return;
+	}
+
+	PlayerCharacter->DeactivateForPool();
+	Available.AddUnique(PlayerCharacter);
+}
+
+void FSafeZoneCharacterPool::Prewarm(UWorld* World, TSubclassOf<AGamePlayerCharacter> CharacterClass, int32 Count)
+{
+	if (!World || !CharacterClass)
+	{
+		return;
+	}
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AlwaysSpawn;
+
+	for (int32 Index = 0; Index < Count; ++Index)
+	{
+		Release(World->SpawnActor<AGamePlayerCharacter>(CharacterClass, FTransform::Identity, SpawnParams));
+	}
+}
+
+void FSafeZoneCharacterPool::Reset()
+{
+	for (const TWeakObjectPtr<AGamePlayerCharacter>& PlayerCharacter : Available)
+	{
+		if (PlayerCharacter.IsValid())
+		{
+			PlayerCharacter->Destroy();
+		}
+	}
+	Available.Reset();
+}
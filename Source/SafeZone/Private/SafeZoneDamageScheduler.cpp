@@ -0,0 +1,172 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SafeZoneDamageScheduler.h"
+#include "GamePlayerCharacter.h"
+#include "GamePlayerController.h"
+#include "AbilitySystemGlobals.h"
+#include "SafeZoneStats.h"
+#include "SafeZoneGameplayTags.h"
+#include "PlayerAttributeSet.h"
+
+// Feedback for the damaged player only, batched with its other local cues of the frame
+static void QueueDamageCue(AGamePlayerCharacter* PlayerCharacter, float Damage)
+{
+	if (AGamePlayerController* PlayerController = PlayerCharacter->GetController<AGamePlayerController>())
+	{
+		PlayerController->QueueLocalGameplayCue(FSafeZoneGameplayTags::Get().GameplayCue_SafeZone_Damage, Damage);
+	}
+}
+
+FSafeZoneDamageScheduler::FSafeZoneDamageScheduler()
+	: bApplyDirectly(false)
+	, StepInterval(1.0f)
+	, MaxStepsPerFrame(4)
+	, Accumulator(0.0f)
+	, LastPassSeconds(0.0)
+	, AveragePassSeconds(0.0)
+	, LastPassApplications(0)
+{
+}
+
+void FSafeZoneDamageScheduler::SetStepInterval(float InStepInterval)
+{
+	StepInterval = FMath::Max(InStepInterval, KINDA_SMALL_NUMBER);
+}
+
+void FSafeZoneDamageScheduler::SetMaxStepsPerFrame(int32 InMaxStepsPerFrame)
+{
+	MaxStepsPerFrame = FMath::Max(InMaxStepsPerFrame, 1);
+}
+
+void FSafeZoneDamageScheduler::AddPlayer(AGamePlayerCharacter* PlayerCharacter)
+{
+	if (PlayerCharacter)
+	{
+		Players.AddUnique(PlayerCharacter);
+	}
+}
+
+void FSafeZoneDamageScheduler::RemovePlayer(AGamePlayerCharacter* PlayerCharacter)
+{
+	const int32 Index = Players.IndexOfByKey(PlayerCharacter);
+	if (Index != INDEX_NONE)
+	{
+		Players.RemoveAtSwap(Index, 1, false);
+	}
+}
+
+int32 FSafeZoneDamageScheduler::Advance(float DeltaSeconds, float DamagePerStep)
+{
+	Accumulator += DeltaSeconds;
+
+	int32 Steps = 0;
+	int32 Applications = 0;
+	while (Accumulator >= StepInterval && Steps < MaxStepsPerFrame)
+	{
+		Accumulator -= StepInterval;
+		RunPass(DamagePerStep);
+		Applications += LastPassApplications;
+		Steps++;
+	}
+
+	return Applications;
+}
+
+void FSafeZoneDamageScheduler::Reset()
+{
+	Players.Reset();
+	CachedSpecs.Reset();
+	SharedContext.Clear();
+	Accumulator = 0.0f;
+	LastPassSeconds = 0.0;
+	AveragePassSeconds = 0.0;
+	LastPassApplications = 0;
+}
+
+void FSafeZoneDamageScheduler::RunPass(float Damage)
+{
+	SCOPE_CYCLE_COUNTER(STAT_SafeZone_DamagePass);
+	CSV_SCOPED_TIMING_STAT(SafeZone, DamagePass);
+
+	const uint64 StartCycles = FPlatformTime::Cycles64();
+
+	int32 Applications = 0;
+
+	// Backwards, a player that dies from this pass removes itself with a swap from the processed tail
+	for (int32 Index = Players.Num() - 1; Index >= 0; --Index)
+	{
+		AGamePlayerCharacter* PlayerCharacter = Players[Index].Get();
+		UAbilitySystemComponent* AbilitySystemComponent = PlayerCharacter ? PlayerCharacter->GetAbilitySystemComponent() : nullptr;
+		if (!AbilitySystemComponent || !PlayerCharacter->IsCharacterAlive())
+		{
+			Players.RemoveAtSwap(Index, 1, false);
+			continue;
+		}
+
+		if (bApplyDirectly)
+		{
+			// Same clamp as the damage branch of UPlayerAttributeSet::PostGameplayEffectExecute
+			if (const UPlayerAttributeSet* Attributes = AbilitySystemComponent->GetSet<UPlayerAttributeSet>())
+			{
+				const float NewHealth = FMath::Clamp(Attributes->GetHealth() - Damage, 0.0f, Attributes->GetMaxHealth());
+				AbilitySystemComponent->SetNumericAttributeBase(UPlayerAttributeSet::GetHealthAttribute(), NewHealth);
+				QueueDamageCue(PlayerCharacter, Damage);
+				Applications++;
+			}
+			continue;
+		}
+
+		const int32 SpecIndex = FindOrCreateSpec(EffectClass, Damage);
+		if (SpecIndex != INDEX_NONE)
+		{
+			// Copied into the active effect container, this allocates on every application
+			AbilitySystemComponent->ApplyGameplayEffectSpecToSelf(CachedSpecs[SpecIndex].Spec);
+			QueueDamageCue(PlayerCharacter, Damage);
+			Applications++;
+		}
+	}
+
+	LastPassApplications = Applications;
+	LastPassSeconds = FPlatformTime::ToSeconds64(FPlatformTime::Cycles64() - StartCycles);
+	AveragePassSeconds = AveragePassSeconds > 0.0 ? FMath::Lerp(AveragePassSeconds, LastPassSeconds, 0.1) : LastPassSeconds;
+}
+
+void FSafeZoneDamageScheduler::PrebuildSpecs(TSubclassOf<UGameplayEffect> SpecEffectClass, const TArray<float>& Damages)
+{
+	for (const float Damage : Damages)
+	{
+		FindOrCreateSpec(SpecEffectClass, Damage);
+	}
+}
+
+int32 FSafeZoneDamageScheduler::FindOrCreateSpec(TSubclassOf<UGameplayEffect> SpecEffectClass, float Damage)
+{
+	if (!SpecEffectClass)
+	{
+		return INDEX_NONE;
+	}
+
+	// A handful of entries at most, one per damage level
+	for (int32 Index = 0; Index < CachedSpecs.Num(); ++Index)
+	{
+		if (CachedSpecs[Index].EffectClass == SpecEffectClass && CachedSpecs[Index].Damage == Damage)
+		{
+			return Index;
+		}
+	}
+
+	if (!SharedContext.IsValid())
+	{
+		SharedContext = FGameplayEffectContextHandle(UAbilitySystemGlobals::Get().AllocGameplayEffectContext());
+	}
+
+	const int32 Index = CachedSpecs.AddDefaulted();
+	FCachedSpec& CachedSpec = CachedSpecs[Index];
+	CachedSpec.EffectClass = SpecEffectClass;
+	CachedSpec.Damage = Damage;
+	CachedSpec.Spec = FGameplayEffectSpec(SpecEffectClass->GetDefaultObject<UGameplayEffect>(), SharedContext, 1.0f);
+	CachedSpec.Spec.SetSetByCallerMagnitude(FSafeZoneGameplayTags::Get().Data_Damage, Damage);
+
+	return Index;
+}
@@ -1,210 +1,834 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-
-#include "SafeZoneGameMode.h"
-#include "GamePlayerCharacter.h"
-#include "QuadrantSystemActor.h"
-#include "SafeZoneActor.h"
-#include "Kismet/GameplayStatics.h"
-#include "GameFramework/PlayerState.h"
-#include "SafeZoneGameState.h"
-#include "GamePlayerController.h"
-#include "UObject/ConstructorHelpers.h"
-
-
-ASafeZoneGameMode::ASafeZoneGameMode()
-{
-    currentPlayerQuadrant = nullptr;
-}
-
-void ASafeZoneGameMode::BeginPlay()
-{
-    Super::BeginPlay();
-
-    TArray<AActor*> FoundActors;
-    UGameplayStatics::GetAllActorsOfClass(GetWorld(), ASafeZoneActor::StaticClass(), FoundActors);
-
-    if (FoundActors.Num() > 0)
-    {
-        safeZoneActor_Ref = Cast<ASafeZoneActor>(FoundActors[0]);
-        // Optionally, handle cases where there are multiple actors
-    }
-}
-
-void ASafeZoneGameMode::PostLogin(APlayerController* NewPlayer)
-{
-    Super::PostLogin(NewPlayer);
-    
-    ASafeZoneGameState* GS = GetGameState<ASafeZoneGameState>();
-    if (GS)
-    {
-        GS->PlayerCount++;
-    }
-}
-
-void ASafeZoneGameMode::Logout(AController* Exiting)
-{
-    Super::Logout(Exiting);
-    ASafeZoneGameState* GS = GetGameState<ASafeZoneGameState>();
-    if (GS)
-    {
-        GS->PlayerCount--;
-
-        if (GS->PlayerCount <= 0)
-        {
-            EndGame();
-        }
-    }
-}
-
-ASafeZoneActor* ASafeZoneGameMode::SpawnSafeZoneActor()
-{
-    // Ensure we have a valid world context
-    UWorld* World = GetWorld();
-    if (!World)
-    {
-        return nullptr;
-    }
-
-    // Define spawn parameters (optional, customize as needed)
-    FActorSpawnParameters SpawnParams;
-    SpawnParams.Owner = this;
-
-    // Define the initial transform for the actor (customize as needed)
-    FTransform SpawnTransform;
-    SpawnTransform.SetLocation(FVector::ZeroVector); // Spawn at world origin, for example
-    SpawnTransform.SetRotation(FQuat::Identity);
-    SpawnTransform.SetScale3D(FVector(1.0f));
-
-    // Spawn the actor
-    ASafeZoneActor* SpawnedActor = World->SpawnActor<ASafeZoneActor>(ASafeZoneActor::StaticClass(), SpawnTransform, SpawnParams);
-
-    return SpawnedActor;
-}
-
-
-void ASafeZoneGameMode::UpdatePlayerQuadrant(FString PlayerID, AQuadrantSystemActor* Quadrant)
-{
-    if (Quadrant)
-    {
-        PlayerQuadrantMap.Add(PlayerID, Quadrant);
-        UE_LOG(LogTemp, Warning, TEXT("Adding player %s in quadrant %s"), *PlayerID, *Quadrant->GetName());
-
-        RemoveOutsideSafeZoneTagIfApplicable(PlayerID);
-    }
-    else
-    {
-        PlayerQuadrantMap.Remove(PlayerID);
-        UE_LOG(LogTemp, Warning, TEXT("Removing player %s from quadrant"), *PlayerID);
-
-        ApplyOutsideSafeZoneTagIfApplicable(PlayerID);
-    }
-}
-
-void ASafeZoneGameMode::DelayedUpdatePlayerQuadrant(FString PlayerID)
-{
-    if (IsPlayerInAnyQuadrant(PlayerID))
-    {
-        UpdatePlayerQuadrant(PlayerID, currentPlayerQuadrant);
-        UE_LOG(LogTemp, Warning, TEXT("Player %s is in quadrant %s"), *PlayerID, *currentPlayerQuadrant->GetName());
-    }
-    else
-    {
-        PlayerQuadrantMap.Remove(PlayerID);
-        UE_LOG(LogTemp, Warning, TEXT("Removing player %s from quadrant"), *PlayerID);
-
-        ApplyOutsideSafeZoneTagIfApplicable(PlayerID);
-    }
-}
-
-void ASafeZoneGameMode::RemoveOutsideSafeZoneTagIfApplicable(const FString& PlayerID)
-{
-    AGamePlayerCharacter* PlayerCharacter = GetPlayerCharacterFromID(PlayerID);
-    if (PlayerCharacter && PlayerCharacter->GetAbilitySystemComponent()->HasMatchingGameplayTag(FGameplayTag::RequestGameplayTag(FName("State.OutsideSafeZone"))))
-    {
-        PlayerCharacter->GetAbilitySystemComponent()->RemoveLooseGameplayTag(FGameplayTag::RequestGameplayTag(FName("State.OutsideSafeZone")));
-        UE_LOG(LogTemp, Warning, TEXT("Removed OutsideSafeZone tag from player %s"), *PlayerID);
-    }
-}
-
-void ASafeZoneGameMode::ApplyOutsideSafeZoneTagIfApplicable(const FString& PlayerID)
-{
-    AGamePlayerCharacter* PlayerCharacter = GetPlayerCharacterFromID(PlayerID);
-    if (PlayerCharacter && !IsPlayerInSafeZone(PlayerCharacter)
-        && !PlayerCharacter->GetAbilitySystemComponent()->HasMatchingGameplayTag(FGameplayTag::RequestGameplayTag(FName("State.OutsideSafeZone"))))
-    {
-        PlayerCharacter->GetAbilitySystemComponent()->AddLooseGameplayTag(FGameplayTag::RequestGameplayTag(FName("State.OutsideSafeZone")));
-        UE_LOG(LogTemp, Warning, TEXT("Player %s is outside safezone, tag set"), *PlayerID);
-    }
-}
-
-bool ASafeZoneGameMode::IsPlayerInSafeZone(AGamePlayerCharacter* PlayerCharacter)
-{
-    if (PlayerCharacter && safeZoneActor_Ref)
-    {
-        return safeZoneActor_Ref->IsOverlappingActor(PlayerCharacter);
-    }
-    return false;
-}
-
-AGamePlayerCharacter* ASafeZoneGameMode::GetPlayerCharacterFromID(const FString& PlayerID)
-{
-    for (auto It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
-    {
-        APlayerController* PC = It->Get();
-        if (PC && PC->PlayerState && PC->PlayerState->GetUniqueId().ToString() == PlayerID)
-        {
-            return Cast<AGamePlayerCharacter>(PC->GetPawn());
-        }
-    }
-    return nullptr;
-}
-
-void ASafeZoneGameMode::StartQuadrantUpdateDelay(FString PlayerID, float DelayTime)
-{
-    // Start a timer to delay the update
-    FTimerHandle TimerHandle;
-    GetWorld()->GetTimerManager().SetTimer(TimerHandle, FTimerDelegate::CreateUObject(this, &ASafeZoneGameMode::DelayedUpdatePlayerQuadrant, PlayerID), DelayTime, false);
-}
-
-bool ASafeZoneGameMode::IsPlayerInAnyQuadrant(const FString& PlayerID)
-{
-    // Iterate through all quadrants to check if player is in any of them
-    for (AQuadrantSystemActor* Quadrant : safeZoneActor_Ref->GetQuadrantsInSafeZone())
-    {
-        if (Quadrant && Quadrant->IsPlayerInside(PlayerID))
-        {
-            currentPlayerQuadrant = Quadrant;
-
-            return true; // Player is inside one of the quadrants
-        }
-    }
-    return false; // Player is not inside any quadrant
-}
-
-void ASafeZoneGameMode::ManagePlayerCount()
-{
-    ASafeZoneGameState* GS = GetGameState<ASafeZoneGameState>();
-    if (GS)
-    {
-        GS->PlayerCount--;
-    };
-
-    if (GS->PlayerCount <= 0)
-    {
-        EndGame();
-    }
-}
-
-void ASafeZoneGameMode::EndGame()
-{
-    // Assuming your widget class is UGameOverWidget
-    for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
-    {
-        AGamePlayerController* PlayerController = Cast<AGamePlayerController>(It->Get());
-        if (PlayerController)
-        {
-           PlayerController->EndGameReturnToMain();   
-        }
-    }
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SafeZoneGameMode.h"
+#include "GamePlayerCharacter.h"
+#include "QuadrantSystemActor.h"
+#include "SafeZoneActor.h"
+#include "GameFramework/PlayerState.h"
+#include "SafeZoneGameState.h"
+#include "GamePlayerController.h"
+#include "UObject/ConstructorHelpers.h"
+#include "EngineUtils.h"
+#include "SafeZoneStats.h"
+#include "SafeZoneLoadTestDirector.h"
+#include "SafeZoneSubsystem.h"
+#include "ZoneDamageGameplayEffect.h"
+
+
+// Set by MarkLevelReloadStart, survives the level change since the module stays loaded
+static double GLevelReloadStartTime = 0.0;
+
+ASafeZoneGameMode::ASafeZoneGameMode()
+{
+    MembershipUpdateRate = 10.0f;
+    ZoneExitHysteresis = 100.0f;
+    ZoneExitGraceTime = 1.5f;
+
+    ZoneDamageInterval = 1.0f;
+    ZoneDamagePerPhase = { 5.0f, 5.0f, 10.0f, 15.0f, 25.0f };
+    ZoneDamageEffectClass = UZoneDamageGameplayEffect::StaticClass();
+    bApplyZoneDamageDirectly = false;
+    bPoolPlayerCharacters = true;
+
+    MatchStartInitBudgetMs = 2.0f;
+    bMatchStartPipelineDone = false;
+    bRunningMatchStartPipeline = false;
+    MatchStartQueueTime = 0.0;
+    MatchStartFrames = 0;
+    MatchStartInitializedCharacters = 0;
+    MatchStartMaxFrameMs = 0.0f;
+    MatchStartInitSeconds = 0.0f;
+    bResetMatchInPlace = true;
+    PostMatchDelay = 10.0f;
+    LastMatchResetMs = 0.0f;
+
+    NumPlayersOutside = 0;
+    NumPlayersInGrace = 0;
+    DamageApplicationsInWindow = 0;
+    MembershipTransitionsInWindow = 0;
+    StatsWindowTime = 0.0f;
+    DamageApplicationsPerSecond = 0.0f;
+    MembershipTransitionsPerSecond = 0.0f;
+
+    // Drives the zone damage scheduler
+    PrimaryActorTick.bCanEverTick = true;
+}
+
+void ASafeZoneGameMode::BeginPlay()
+{
+    Super::BeginPlay();
+
+    // Zones that began play before the game mode are already registered, later ones come through the delegate
+    if (USafeZoneSubsystem* ZoneSubsystem = GetWorld()->GetSubsystem<USafeZoneSubsystem>())
+    {
+        ZoneRegisteredHandle = ZoneSubsystem->OnZoneRegistered.AddUObject(this, &ASafeZoneGameMode::HandleZoneRegistered);
+        ZoneUnregisteredHandle = ZoneSubsystem->OnZoneUnregistered.AddUObject(this, &ASafeZoneGameMode::HandleZoneUnregistered);
+
+        for (ASafeZoneActor* Zone : ZoneSubsystem->GetZones())
+        {
+            HandleZoneRegistered(Zone);
+        }
+    }
+
+    ZoneDamageScheduler.SetStepInterval(ZoneDamageInterval);
+    ZoneDamageScheduler.SetApplyDirectly(bApplyZoneDamageDirectly);
+    ZoneDamageScheduler.SetEffectClass(ZoneDamageEffectClass);
+    // Every damage level is ready before the first zone damage pass
+    ZoneDamageScheduler.PrebuildSpecs(ZoneDamageEffectClass, ZoneDamagePerPhase);
+
+    GetWorldTimerManager().SetTimer(MembershipTimerHandle, this, &ASafeZoneGameMode::UpdateZoneMembership, 1.0f / FMath::Max(MembershipUpdateRate, 1.0f), true);
+
+    if (GLevelReloadStartTime > 0.0)
+    {
+        UE_LOG(LogTemp, Display, TEXT("Full level reload took %.3f ms"), (FPlatformTime::Seconds() - GLevelReloadStartTime) * 1000.0);
+        GLevelReloadStartTime = 0.0;
+    }
+
+    // -SafeZoneLoadTest=<bots> on a dedicated server
+    ASafeZoneLoadTestDirector::StartFromCommandLine(this);
+}
+
+void ASafeZoneGameMode::Tick(float DeltaSeconds)
+{
+    Super::Tick(DeltaSeconds);
+
+    if (!bMatchStartPipelineDone)
+    {
+        ProcessMatchStartPipeline();
+    }
+
+    DamageApplicationsInWindow += ZoneDamageScheduler.Advance(DeltaSeconds, GetZoneDamageForCurrentPhase());
+
+    UpdateSafeZoneStats(DeltaSeconds);
+}
+
+void ASafeZoneGameMode::RestartPlayer(AController* NewPlayer)
+{
+    if (!bMatchStartPipelineDone && !bRunningMatchStartPipeline && NewPlayer)
+    {
+        if (PendingRestarts.Num() == 0 && PendingInitializations.Num() == 0 && MatchStartFrames == 0)
+        {
+            MatchStartQueueTime = FPlatformTime::Seconds();
+        }
+        PendingRestarts.AddUnique(NewPlayer);
+        return;
+    }
+
+    Super::RestartPlayer(NewPlayer);
+}
+
+bool ASafeZoneGameMode::DeferCharacterInitialization(AGamePlayerCharacter* PlayerCharacter)
+{
+    // Only match participants, characters of unregistered controllers (benchmarks) initialize right away
+    if (bMatchStartPipelineDone || !PlayerCharacter || PlayerRegistry.FindHandle(PlayerCharacter->GetController()) == INDEX_NONE)
+    {
+        return false;
+    }
+
+    if (PendingRestarts.Num() == 0 && PendingInitializations.Num() == 0 && MatchStartFrames == 0)
+    {
+        MatchStartQueueTime = FPlatformTime::Seconds();
+    }
+    PendingInitializations.AddUnique(PlayerCharacter);
+    return true;
+}
+
+void ASafeZoneGameMode::ProcessMatchStartPipeline()
+{
+    if (PendingRestarts.Num() == 0 && PendingInitializations.Num() == 0)
+    {
+        return;
+    }
+
+    SCOPE_CYCLE_COUNTER(STAT_SafeZone_MatchStartInit);
+    CSV_SCOPED_TIMING_STAT(SafeZone, MatchStartInit);
+
+    const double FrameStart = FPlatformTime::Seconds();
+    const double Budget = FMath::Max(MatchStartInitBudgetMs, 0.0f) / 1000.0;
+
+    // Characters first, a restart only adds another one to initialize
+    do
+    {
+        if (PendingInitializations.Num() > 0)
+        {
+            AGamePlayerCharacter* PlayerCharacter = PendingInitializations[0].Get();
+            PendingInitializations.RemoveAt(0, 1, false);
+
+            if (IsValid(PlayerCharacter) && PlayerCharacter->GetController())
+            {
+                PlayerCharacter->InitializeForPlay();
+                MatchStartInitializedCharacters++;
+            }
+        }
+        else
+        {
+            AController* Controller = PendingRestarts[0].Get();
+            PendingRestarts.RemoveAt(0, 1, false);
+
+            if (IsValid(Controller) && !Controller->GetPawn())
+            {
+                TGuardValue<bool> RunningGuard(bRunningMatchStartPipeline, true);
+                RestartPlayer(Controller);
+            }
+        }
+    }
+    while ((PendingRestarts.Num() > 0 || PendingInitializations.Num() > 0) && FPlatformTime::Seconds() - FrameStart < Budget);
+
+    MatchStartFrames++;
+    MatchStartMaxFrameMs = FMath::Max(MatchStartMaxFrameMs, (float)((FPlatformTime::Seconds() - FrameStart) * 1000.0));
+
+    if (PendingRestarts.Num() > 0 || PendingInitializations.Num() > 0)
+    {
+        return;
+    }
+
+    // Everyone who joined so far is ready, later joins and respawns initialize right away
+    bMatchStartPipelineDone = true;
+    MatchStartInitSeconds = (float)(FPlatformTime::Seconds() - MatchStartQueueTime);
+    CSV_CUSTOM_STAT(SafeZone, MatchStartInitSeconds, MatchStartInitSeconds, ECsvCustomStatOp::Set);
+
+    UE_LOG(LogTemp, Display, TEXT("Match start initialization of %d characters took %.3f s over %d frames, longest frame %.3f ms"),
+        MatchStartInitializedCharacters, MatchStartInitSeconds, MatchStartFrames, MatchStartMaxFrameMs);
+
+    if (USafeZoneSubsystem* ZoneSubsystem = GetWorld()->GetSubsystem<USafeZoneSubsystem>())
+    {
+        for (ASafeZoneActor* Zone : ZoneSubsystem->GetZones())
+        {
+            Zone->ActivateZone();
+        }
+    }
+}
+
+void ASafeZoneGameMode::HandleZoneRegistered(ASafeZoneActor* Zone)
+{
+    if (!safeZoneActor_Ref && Zone->GetZoneKind() == ESafeZoneKind::Safe)
+    {
+        safeZoneActor_Ref = Zone;
+    }
+
+    // Once per zone instead of every membership pass
+    const int32 MaxZones = FSafeZoneMembershipBatch::MaxCircles / 2;
+    if (USafeZoneSubsystem* ZoneSubsystem = GetWorld()->GetSubsystem<USafeZoneSubsystem>())
+    {
+        if (ZoneSubsystem->GetZones().Num() > MaxZones)
+        {
+            UE_LOG(LogTemp, Warning, TEXT("%d zones registered, membership only resolves the first %d"), ZoneSubsystem->GetZones().Num(), MaxZones);
+        }
+    }
+
+    // Streamed in or spawned after the match start, its schedule starts right away
+    if (bMatchStartPipelineDone)
+    {
+        Zone->ActivateZone();
+    }
+}
+
+void ASafeZoneGameMode::HandleZoneUnregistered(ASafeZoneActor* Zone)
+{
+    if (safeZoneActor_Ref == Zone)
+    {
+        USafeZoneSubsystem* ZoneSubsystem = GetWorld()->GetSubsystem<USafeZoneSubsystem>();
+        safeZoneActor_Ref = ZoneSubsystem ? ZoneSubsystem->GetPrimarySafeZone() : nullptr;
+    }
+}
+
+void ASafeZoneGameMode::UpdateSafeZoneStats(float DeltaSeconds)
+{
+    StatsWindowTime += DeltaSeconds;
+    if (StatsWindowTime >= 1.0f)
+    {
+        DamageApplicationsPerSecond = DamageApplicationsInWindow / StatsWindowTime;
+        MembershipTransitionsPerSecond = MembershipTransitionsInWindow / StatsWindowTime;
+        DamageApplicationsInWindow = 0;
+        MembershipTransitionsInWindow = 0;
+        StatsWindowTime = 0.0f;
+    }
+
+    SET_DWORD_STAT(STAT_SafeZone_PlayersOutside, NumPlayersOutside);
+    SET_DWORD_STAT(STAT_SafeZone_PlayersInGrace, NumPlayersInGrace);
+    SET_FLOAT_STAT(STAT_SafeZone_DamageApplicationsPerSecond, DamageApplicationsPerSecond);
+    SET_FLOAT_STAT(STAT_SafeZone_TransitionsPerSecond, MembershipTransitionsPerSecond);
+
+    CSV_CUSTOM_STAT(SafeZone, PlayersOutside, NumPlayersOutside, ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(SafeZone, PlayersInGrace, NumPlayersInGrace, ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(SafeZone, DamageApplicationsPerSecond, DamageApplicationsPerSecond, ECsvCustomStatOp::Set);
+    CSV_CUSTOM_STAT(SafeZone, MembershipTransitionsPerSecond, MembershipTransitionsPerSecond, ECsvCustomStatOp::Set);
+}
+
+float ASafeZoneGameMode::GetZoneDamageForCurrentPhase() const
+{
+    if (ZoneDamagePerPhase.Num() == 0)
+    {
+        return 0.0f;
+    }
+
+    const int32 Iteration = safeZoneActor_Ref ? safeZoneActor_Ref->GetCurrentIteration() : 0;
+    return ZoneDamagePerPhase[FMath::Clamp(Iteration, 0, ZoneDamagePerPhase.Num() - 1)];
+}
+
+float ASafeZoneGameMode::GetLastZoneDamagePassMs() const
+{
+    return ZoneDamageScheduler.GetLastPassSeconds() * 1000.0;
+}
+
+float ASafeZoneGameMode::GetAverageZoneDamagePassMs() const
+{
+    return ZoneDamageScheduler.GetAveragePassSeconds() * 1000.0;
+}
+
+void ASafeZoneGameMode::UpdateZoneMembership()
+{
+    USafeZoneSubsystem* ZoneSubsystem = GetWorld()->GetSubsystem<USafeZoneSubsystem>();
+    if (!ZoneSubsystem || ZoneSubsystem->GetZones().Num() == 0)
+    {
+        return;
+    }
+
+    SCOPE_CYCLE_COUNTER(STAT_SafeZone_Membership);
+    CSV_SCOPED_TIMING_STAT(SafeZone, Membership);
+
+    const TArray<ASafeZoneActor*>& Zones = ZoneSubsystem->GetZones();
+    const int32 MaxZones = FSafeZoneMembershipBatch::MaxCircles / 2;
+    const int32 NumZones = FMath::Min(Zones.Num(), MaxZones);
+
+    // Circles of every zone, so all of them are resolved in a single pass over the players
+    const float Hysteresis = FMath::Max(ZoneExitHysteresis, 0.0f);
+    uint32 SafeEnterBits = 0;
+    uint32 SafeStayBits = 0;
+    uint32 HazardBits = 0;
+    uint32 HazardCoreBits = 0;
+    ZoneCircleCenters.Reset();
+    ZoneCircleRadii.Reset();
+    for (int32 ZoneIndex = 0; ZoneIndex < NumZones; ++ZoneIndex)
+    {
+        FVector ZoneCenter;
+        float ZoneRadius;
+        Zones[ZoneIndex]->GetCurrentZone(ZoneCenter, ZoneRadius);
+
+        ZoneCircleCenters.Add(FVector2D(ZoneCenter));
+        ZoneCircleCenters.Add(FVector2D(ZoneCenter));
+        ZoneCircleRadii.Add(ZoneRadius);
+
+        const uint32 RadiusBit = 1u << (2 * ZoneIndex);
+        const uint32 HysteresisBit = 1u << (2 * ZoneIndex + 1);
+        if (Zones[ZoneIndex]->GetZoneKind() == ESafeZoneKind::Safe)
+        {
+            ZoneCircleRadii.Add(ZoneRadius + Hysteresis);
+            SafeEnterBits |= RadiusBit;
+            SafeStayBits |= HysteresisBit;
+        }
+        else
+        {
+            // Players are only pushed out once they are the hysteresis distance deep into a hazard
+            ZoneCircleRadii.Add(FMath::Max(ZoneRadius - Hysteresis, 0.0f));
+            HazardBits |= RadiusBit;
+            HazardCoreBits |= HysteresisBit;
+        }
+    }
+
+    // Gather every live player into contiguous arrays
+    MembershipBatch.Reset();
+    MembershipHandles.Reset();
+    for (int32 Handle = 0; Handle < PlayerRegistry.GetNumHandles(); ++Handle)
+    {
+        if (!PlayerRegistry.IsValidHandle(Handle))
+        {
+            continue;
+        }
+
+        AGamePlayerCharacter* PlayerCharacter = PlayerRegistry.GetCharacter(Handle);
+        if (PlayerCharacter && PlayerRegistry.IsAlive(Handle))
+        {
+            const FVector Location = PlayerCharacter->GetActorLocation();
+            PlayerRegistry.SetPosition(Handle, Location);
+            MembershipHandles.Add(Handle);
+            MembershipBatch.Add(Location);
+        }
+        else
+        {
+            RemovePlayerFromGrid(Handle);
+        }
+    }
+
+    MembershipBatch.TestCircles(ZoneCircleCenters, ZoneCircleRadii, ZoneCircleMasks);
+
+    // Without any safe zone everything outside the hazards is safe
+    const float WorldTime = GetWorld()->GetTimeSeconds();
+    NumPlayersOutside = 0;
+    NumPlayersInGrace = 0;
+    for (int32 Index = 0; Index < MembershipHandles.Num(); ++Index)
+    {
+        const int32 Handle = MembershipHandles[Index];
+        const uint32 Mask = ZoneCircleMasks[Index];
+        const bool bInsideEnterRadius = (SafeEnterBits == 0 || (Mask & SafeEnterBits) != 0) && (Mask & HazardBits) == 0;
+        const bool bInsideStayRadius = (SafeStayBits == 0 || (Mask & SafeStayBits) != 0) && (Mask & HazardCoreBits) == 0;
+        AdvanceZoneState(Handle, bInsideEnterRadius, bInsideStayRadius, WorldTime);
+        PlayerRegistry.SetQuadrant(Handle, INDEX_NONE);
+
+        NumPlayersOutside += PlayerRegistry.GetZoneState(Handle) == ESafeZonePlayerZoneState::Outside ? 1 : 0;
+        NumPlayersInGrace += PlayerRegistry.GetZoneState(Handle) == ESafeZonePlayerZoneState::Grace ? 1 : 0;
+    }
+
+    // Each safe zone's density grid holds the players within its widened radius, so sub-matches don't steer each other
+    for (int32 ZoneIndex = 0; ZoneIndex < NumZones; ++ZoneIndex)
+    {
+        ASafeZoneActor* Zone = Zones[ZoneIndex];
+        if (Zone->GetZoneKind() != ESafeZoneKind::Safe)
+        {
+            continue;
+        }
+
+        const uint32 HysteresisBit = 1u << (2 * ZoneIndex + 1);
+        for (int32 Index = 0; Index < MembershipHandles.Num(); ++Index)
+        {
+            if (ZoneCircleMasks[Index] & HysteresisBit)
+            {
+                Zone->TrackPlayer(MembershipHandles[Index], PlayerRegistry.GetPosition(MembershipHandles[Index]));
+            }
+            else
+            {
+                Zone->UntrackPlayer(MembershipHandles[Index]);
+            }
+        }
+    }
+
+    // Quadrant occupancy comes from the same positions
+    SCOPE_CYCLE_COUNTER(STAT_SafeZone_QuadrantOccupancy);
+    CSV_SCOPED_TIMING_STAT(SafeZone, QuadrantOccupancy);
+
+    for (int32 ZoneIndex = 0; ZoneIndex < NumZones; ++ZoneIndex)
+    {
+        TArray<FSafeZoneQuadrant>& Quadrants = Zones[ZoneIndex]->GetQuadrantsInSafeZone();
+        for (int32 QuadrantIndex = 0; QuadrantIndex < Quadrants.Num(); ++QuadrantIndex)
+        {
+            FSafeZoneQuadrant& Quadrant = Quadrants[QuadrantIndex];
+            Quadrant.ResetPlayersInQuadrant();
+            MembershipBatch.TestCircle(FVector2D(Quadrant.Center), Quadrant.Radius, QuadrantInsideFlags);
+            for (int32 Index = 0; Index < QuadrantInsideFlags.Num(); ++Index)
+            {
+                if (QuadrantInsideFlags[Index])
+                {
+                    const int32 Handle = MembershipHandles[Index];
+                    if (PlayerRegistry.GetCharacter(Handle))
+                    {
+                        Quadrant.AddPlayerToQuadrant(Handle);
+                    }
+
+                    if (PlayerRegistry.GetQuadrant(Handle) == INDEX_NONE)
+                    {
+                        PlayerRegistry.SetQuadrant(Handle, QuadrantIndex);
+                    }
+                }
+            }
+        }
+    }
+}
+
+void ASafeZoneGameMode::AdvanceZoneState(int32 PlayerHandle, bool bInsideEnterRadius, bool bInsideStayRadius, float WorldTime)
+{
+    const ESafeZonePlayerZoneState PreviousState = PlayerRegistry.GetZoneState(PlayerHandle);
+    ESafeZonePlayerZoneState State = PreviousState;
+
+    if (State == ESafeZonePlayerZoneState::Inside && !bInsideStayRadius)
+    {
+        State = ESafeZonePlayerZoneState::Grace;
+        PlayerRegistry.SetGraceEndTime(PlayerHandle, WorldTime + FMath::Max(ZoneExitGraceTime, 0.0f));
+    }
+
+    if (State == ESafeZonePlayerZoneState::Grace)
+    {
+        if (bInsideEnterRadius)
+        {
+            // Back before the grace time ran out, the tag was never applied
+            State = ESafeZonePlayerZoneState::Inside;
+        }
+        else if (WorldTime >= PlayerRegistry.GetGraceEndTime(PlayerHandle))
+        {
+            State = ESafeZonePlayerZoneState::Outside;
+            SetOutsideSafeZoneTag(PlayerHandle, true);
+        }
+    }
+    else if (State == ESafeZonePlayerZoneState::Outside && bInsideEnterRadius)
+    {
+        State = ESafeZonePlayerZoneState::Inside;
+        SetOutsideSafeZoneTag(PlayerHandle, false);
+    }
+
+    if (State != PreviousState)
+    {
+        PlayerRegistry.SetZoneState(PlayerHandle, State);
+        MembershipTransitionsInWindow++;
+    }
+}
+
+void ASafeZoneGameMode::PostLogin(APlayerController* NewPlayer)
+{
+    // Registered first, the default pawn is possessed during Super::PostLogin
+    if (NewPlayer)
+    {
+        RegisterPlayerController(NewPlayer);
+    }
+
+    Super::PostLogin(NewPlayer);
+}
+
+void ASafeZoneGameMode::Logout(AController* Exiting)
+{
+    const int32 Handle = PlayerRegistry.FindHandle(Exiting);
+    if (Handle != INDEX_NONE)
+    {
+        RemovePlayerFromGrid(Handle);
+        if (AGamePlayerCharacter* PlayerCharacter = PlayerRegistry.GetCharacter(Handle))
+        {
+            PlayerCharacter->SetPlayerHandle(INDEX_NONE);
+        }
+        PlayerRegistry.FreeHandle(Handle);
+
+        if (ASafeZoneGameState* GS = GetGameState<ASafeZoneGameState>())
+        {
+            GS->ClearPlayerSlot(Handle);
+            GS->GetRoster().RemovePlayer(Handle);
+        }
+    }
+
+    Super::Logout(Exiting);
+
+    ManagePlayerCount();
+}
+
+void ASafeZoneGameMode::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    CharacterPool.Reset();
+
+    if (USafeZoneSubsystem* ZoneSubsystem = GetWorld()->GetSubsystem<USafeZoneSubsystem>())
+    {
+        ZoneSubsystem->OnZoneRegistered.Remove(ZoneRegisteredHandle);
+        ZoneSubsystem->OnZoneUnregistered.Remove(ZoneUnregisteredHandle);
+    }
+
+    Super::EndPlay(EndPlayReason);
+}
+
+APawn* ASafeZoneGameMode::SpawnDefaultPawnAtTransform_Implementation(AController* NewPlayer, const FTransform& SpawnTransform)
+{
+    UClass* PawnClass = GetDefaultPawnClassForController(NewPlayer);
+    if (bPoolPlayerCharacters && PawnClass && PawnClass->IsChildOf(AGamePlayerCharacter::StaticClass()))
+    {
+        if (AGamePlayerCharacter* PooledCharacter = CharacterPool.Acquire(PawnClass, SpawnTransform))
+        {
+            return PooledCharacter;
+        }
+    }
+
+    return Super::SpawnDefaultPawnAtTransform_Implementation(NewPlayer, SpawnTransform);
+}
+
+TSubclassOf<AGamePlayerCharacter> ASafeZoneGameMode::GetPlayerCharacterClass() const
+{
+    if (DefaultPawnClass && DefaultPawnClass->IsChildOf(AGamePlayerCharacter::StaticClass()))
+    {
+        return DefaultPawnClass.Get();
+    }
+    return AGamePlayerCharacter::StaticClass();
+}
+
+AGamePlayerCharacter* ASafeZoneGameMode::SpawnPlayerCharacter(TSubclassOf<AGamePlayerCharacter> CharacterClass, const FTransform& SpawnTransform)
+{
+    if (bPoolPlayerCharacters)
+    {
+        if (AGamePlayerCharacter* PooledCharacter = CharacterPool.Acquire(CharacterClass, SpawnTransform))
+        {
+            return PooledCharacter;
+        }
+    }
+
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+    return GetWorld()->SpawnActor<AGamePlayerCharacter>(CharacterClass, SpawnTransform, SpawnParams);
+}
+
+void ASafeZoneGameMode::ReleasePlayerCharacter(AGamePlayerCharacter* PlayerCharacter)
+{
+    if (!PlayerCharacter)
+    {
+        return;
+    }
+
+    // The handle stays with the controller, only the character is let go
+    const int32 Handle = PlayerCharacter->GetPlayerHandle();
+    if (PlayerRegistry.IsValidHandle(Handle) && PlayerRegistry.GetCharacter(Handle) == PlayerCharacter)
+    {
+        RemovePlayerFromGrid(Handle);
+        PlayerRegistry.BindCharacter(Handle, nullptr, 0.0f);
+    }
+    ZoneDamageScheduler.RemovePlayer(PlayerCharacter);
+
+    if (bPoolPlayerCharacters)
+    {
+        CharacterPool.Release(PlayerCharacter);
+    }
+    else
+    {
+        PlayerCharacter->Destroy();
+    }
+}
+
+ASafeZoneActor* ASafeZoneGameMode::SpawnSafeZoneActor()
+{
+    // Ensure we have a valid world context
+    UWorld* World = GetWorld();
+    if (!World)
+    {
+        return nullptr;
+    }
+
+    // Define spawn parameters (optional, customize as needed)
+    FActorSpawnParameters SpawnParams;
+    SpawnParams.Owner = this;
+
+    // Define the initial transform for the actor (customize as needed)
+    FTransform SpawnTransform;
+    SpawnTransform.SetLocation(FVector::ZeroVector); // Spawn at world origin, for example
+    SpawnTransform.SetRotation(FQuat::Identity);
+    SpawnTransform.SetScale3D(FVector(1.0f));
+
+    // Spawn the actor
+    ASafeZoneActor* SpawnedActor = World->SpawnActor<ASafeZoneActor>(ASafeZoneActor::StaticClass(), SpawnTransform, SpawnParams);
+
+    return SpawnedActor;
+}
+
+
+int32 ASafeZoneGameMode::RegisterPlayerController(AController* Controller)
+{
+    const int32 Handle = PlayerRegistry.AllocateHandle(Controller);
+
+    if (ASafeZoneGameState* GS = GetGameState<ASafeZoneGameState>())
+    {
+        const FString DisplayName = Controller->PlayerState ? Controller->PlayerState->GetPlayerName() : Controller->GetName();
+        GS->GetRoster().AddPlayer(Handle, DisplayName);
+    }
+
+    return Handle;
+}
+
+void ASafeZoneGameMode::RegisterPlayerCharacter(AGamePlayerCharacter* PlayerCharacter)
+{
+    const int32 Handle = PlayerCharacter ? PlayerRegistry.FindHandle(PlayerCharacter->GetController()) : INDEX_NONE;
+    if (Handle == INDEX_NONE)
+    {
+        return;
+    }
+
+    PlayerRegistry.BindCharacter(Handle, PlayerCharacter, PlayerCharacter->GetCharacterHealth());
+    PlayerCharacter->SetPlayerHandle(Handle);
+
+    // A new character starts inside, alive and standing, a respawn brings the roster entry back
+    if (ASafeZoneGameState* GS = GetGameState<ASafeZoneGameState>())
+    {
+        GS->ClearPlayerSlot(Handle);
+
+        if (const FSafeZoneRosterEntry* Entry = GS->GetRoster().Find(Handle))
+        {
+            GS->GetRoster().AddPlayer(Handle, Entry->DisplayName);
+        }
+    }
+}
+
+void ASafeZoneGameMode::SetPlayerKnocked(int32 PlayerHandle, bool bKnocked)
+{
+    if (!PlayerRegistry.IsValidHandle(PlayerHandle))
+    {
+        return;
+    }
+
+    PlayerRegistry.SetKnocked(PlayerHandle, bKnocked);
+
+    if (ASafeZoneGameState* GS = GetGameState<ASafeZoneGameState>())
+    {
+        GS->SetPlayerSlotFlag(PlayerHandle, ESafeZonePlayerSlotFlag::Knocked, bKnocked);
+        GS->GetRoster().SetKnocked(PlayerHandle, bKnocked);
+
+        if (bKnocked)
+        {
+            GS->QueueCosmeticEvent(ESafeZoneCosmeticEventType::Knockdown, PlayerHandle);
+        }
+    }
+}
+
+void ASafeZoneGameMode::SetPlayerDead(int32 PlayerHandle)
+{
+    if (!PlayerRegistry.IsValidHandle(PlayerHandle))
+    {
+        return;
+    }
+
+    PlayerRegistry.SetAlive(PlayerHandle, false);
+
+    if (ASafeZoneGameState* GS = GetGameState<ASafeZoneGameState>())
+    {
+        GS->SetPlayerSlotFlag(PlayerHandle, ESafeZonePlayerSlotFlag::Dead, true);
+        GS->GetRoster().Eliminate(PlayerHandle);
+        GS->QueueCosmeticEvent(ESafeZoneCosmeticEventType::Death, PlayerHandle);
+    }
+}
+
+void ASafeZoneGameMode::SetOutsideSafeZoneTag(int32 PlayerHandle, bool bOutside)
+{
+    if (ASafeZoneGameState* GS = GetGameState<ASafeZoneGameState>())
+    {
+        GS->SetPlayerSlotFlag(PlayerHandle, ESafeZonePlayerSlotFlag::Outside, bOutside);
+    }
+
+    AGamePlayerCharacter* PlayerCharacter = PlayerRegistry.GetCharacter(PlayerHandle);
+    if (!PlayerCharacter)
+    {
+        return;
+    }
+
+    // Counted by the membership transitions stat, a log line per transition would flood large matches
+    if (bOutside)
+    {
+        PlayerCharacter->ApplyOutsideSafeZoneTag();
+    }
+    else
+    {
+        PlayerCharacter->RemoveOutsideSafeZoneTag();
+    }
+}
+
+void ASafeZoneGameMode::RemovePlayerFromGrid(int32 PlayerHandle)
+{
+    if (USafeZoneSubsystem* ZoneSubsystem = GetWorld()->GetSubsystem<USafeZoneSubsystem>())
+    {
+        for (ASafeZoneActor* Zone : ZoneSubsystem->GetZones())
+        {
+            Zone->UntrackPlayer(PlayerHandle);
+        }
+    }
+}
+
+void ASafeZoneGameMode::ManagePlayerCount()
+{
+    // Deaths and leavers are already taken off the roster
+    ASafeZoneGameState* GS = GetGameState<ASafeZoneGameState>();
+    if (GS && GS->GetPlayerCount() <= 0)
+    {
+        EndGame();
+    }
+}
+
+void ASafeZoneGameMode::EndGame()
+{
+    if (bResetMatchInPlace)
+    {
+        // Clients stay connected and see the end of the match until the next one starts
+        if (!GetWorldTimerManager().TimerExists(MatchResetTimerHandle))
+        {
+            if (PostMatchDelay > 0.0f)
+            {
+                GetWorldTimerManager().SetTimer(MatchResetTimerHandle, this, &ASafeZoneGameMode::ResetMatch, PostMatchDelay, false);
+            }
+            else
+            {
+                // Not from inside the death or logout that ended the match
+                MatchResetTimerHandle = GetWorldTimerManager().SetTimerForNextTick(this, &ASafeZoneGameMode::ResetMatch);
+            }
+        }
+        return;
+    }
+
+    for (FConstPlayerControllerIterator It = GetWorld()->GetPlayerControllerIterator(); It; ++It)
+    {
+        AGamePlayerController* PlayerController = Cast<AGamePlayerController>(It->Get());
+        if (PlayerController)
+        {
+           PlayerController->EndGameReturnToMain();   
+        }
+    }
+}
+
+void ASafeZoneGameMode::ResetMatch()
+{
+    const double StartTime = FPlatformTime::Seconds();
+
+    // Controllers keep their handles, their characters go back to the pool
+    TArray<AController*> Controllers;
+    for (int32 Handle = 0; Handle < PlayerRegistry.GetNumHandles(); ++Handle)
+    {
+        if (!PlayerRegistry.IsValidHandle(Handle))
+        {
+            continue;
+        }
+
+        if (AGamePlayerCharacter* PlayerCharacter = PlayerRegistry.GetCharacter(Handle))
+        {
+            if (AController* Controller = PlayerCharacter->GetController())
+            {
+                Controller->UnPossess();
+            }
+            ReleasePlayerCharacter(PlayerCharacter);
+        }
+
+        if (AController* Controller = PlayerRegistry.GetController(Handle))
+        {
+            Controllers.Add(Controller);
+        }
+    }
+
+    ZoneDamageScheduler.Reset();
+    ZoneDamageScheduler.SetStepInterval(ZoneDamageInterval);
+    ZoneDamageScheduler.SetApplyDirectly(bApplyZoneDamageDirectly);
+    ZoneDamageScheduler.SetEffectClass(ZoneDamageEffectClass);
+    // Every damage level is ready before the first zone damage pass
+    ZoneDamageScheduler.PrebuildSpecs(ZoneDamageEffectClass, ZoneDamagePerPhase);
+    MembershipBatch.Reset();
+    MembershipHandles.Reset();
+    ZoneCircleMasks.Reset();
+    QuadrantInsideFlags.Reset();
+
+    NumPlayersOutside = 0;
+    NumPlayersInGrace = 0;
+    DamageApplicationsInWindow = 0;
+    MembershipTransitionsInWindow = 0;
+    StatsWindowTime = 0.0f;
+    DamageApplicationsPerSecond = 0.0f;
+    MembershipTransitionsPerSecond = 0.0f;
+
+    if (USafeZoneSubsystem* ZoneSubsystem = GetWorld()->GetSubsystem<USafeZoneSubsystem>())
+    {
+        for (ASafeZoneActor* Zone : ZoneSubsystem->GetZones())
+        {
+            Zone->ResetZone();
+        }
+    }
+
+    if (ASafeZoneGameState* GS = GetGameState<ASafeZoneGameState>())
+    {
+        GS->ResetMatchState();
+    }
+
+    // The zone activates again once everyone has been restarted through the pipeline
+    PendingRestarts.Reset();
+    PendingInitializations.Reset();
+    bMatchStartPipelineDone = false;
+    MatchStartFrames = 0;
+    MatchStartInitializedCharacters = 0;
+    MatchStartMaxFrameMs = 0.0f;
+    MatchStartInitSeconds = 0.0f;
+
+    for (AController* Controller : Controllers)
+    {
+        RegisterPlayerController(Controller);
+        RestartPlayer(Controller);
+    }
+
+    LastMatchResetMs = (float)((FPlatformTime::Seconds() - StartTime) * 1000.0);
+    UE_LOG(LogTemp, Display, TEXT("Match reset in place with %d players took %.3f ms"), Controllers.Num(), LastMatchResetMs);
+}
+
+void ASafeZoneGameMode::MarkLevelReloadStart()
+{
+    GLevelReloadStartTime = FPlatformTime::Seconds();
 }
\ No newline at end of file
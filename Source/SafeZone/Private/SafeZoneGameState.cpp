@@ -3,15 +3,186 @@
 
 #include "SafeZoneGameState.h"
 #include "Net/UnrealNetwork.h"
+#include "Net/Core/PushModel/PushModel.h"
+#include "Engine/World.h"
 
-void ASafeZoneGameState::OnRep_PlayerCount()
+ASafeZoneGameState::ASafeZoneGameState()
 {
-    // Optionally do something when PlayerCount changes, like updating UI
+    Roster.Owner = this;
+    MaxCosmeticEventsPerBatch = 64;
+}
+
+void ASafeZoneGameState::BeginPlay()
+{
+    Super::BeginPlay();
+
+    if (HasAuthority())
+    {
+        PendingCosmeticEvents.Start(GetWorld(), MaxCosmeticEventsPerBatch, [this](const TArray<FSafeZoneCosmeticEvent>& Events)
+        {
+            MulticastCosmeticEvents(Events);
+        });
+    }
+}
+
+void ASafeZoneGameState::EndPlay(const EEndPlayReason::Type EndPlayReason)
+{
+    PendingCosmeticEvents.Stop();
+
+    Super::EndPlay(EndPlayReason);
+}
+
+void ASafeZoneGameState::QueueCosmeticEvent(ESafeZoneCosmeticEventType Type, int32 PlayerHandle)
+{
+    if (!HasAuthority())
+    {
+        return;
+    }
+
+    FSafeZoneCosmeticEvent& Event = PendingCosmeticEvents.Add();
+    Event.Type = Type;
+    Event.PlayerHandle = PlayerHandle;
+    Event.ServerTime = GetServerWorldTimeSeconds();
+}
+
+void ASafeZoneGameState::MulticastCosmeticEvents_Implementation(const TArray<FSafeZoneCosmeticEvent>& Events)
+{
+    for (const FSafeZoneCosmeticEvent& Event : Events)
+    {
+        OnCosmeticEvent.Broadcast(Event);
+    }
+}
+
+int32 ASafeZoneGameState::GetPlacement(int32 PlayerHandle) const
+{
+    const FSafeZoneRosterEntry* Entry = Roster.Find(PlayerHandle);
+    return Entry ? Entry->Placement : 0;
+}
+
+void ASafeZoneGameState::NotifyRosterChanged()
+{
+    OnRosterChanged.Broadcast();
 }
 
 void ASafeZoneGameState::GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const
 {
     Super::GetLifetimeReplicatedProps(OutLifetimeProps);
 
-    DOREPLIFETIME(ASafeZoneGameState, PlayerCount);
-}
\ No newline at end of file
+    DOREPLIFETIME(ASafeZoneGameState, Roster);
+
+    // Only compared after a slot actually changed
+    FDoRepLifetimeParams Params;
+    Params.bIsPushBased = true;
+    DOREPLIFETIME_WITH_PARAMS_FAST(ASafeZoneGameState, OutsideBits, Params);
+    DOREPLIFETIME_WITH_PARAMS_FAST(ASafeZoneGameState, KnockedBits, Params);
+    DOREPLIFETIME_WITH_PARAMS_FAST(ASafeZoneGameState, DeadBits, Params);
+}
+
+void ASafeZoneGameState::SetPlayerSlotFlag(int32 Slot, ESafeZonePlayerSlotFlag Flag, bool bValue)
+{
+    if (!HasAuthority() || Slot < 0)
+    {
+        return;
+    }
+
+    TArray<uint32>& Bits = GetSlotBits(Flag);
+    const int32 WordIndex = Slot / 32;
+    const uint32 Mask = 1u << (Slot % 32);
+
+    if (!Bits.IsValidIndex(WordIndex))
+    {
+        if (!bValue)
+        {
+            return;
+        }
+        Bits.SetNumZeroed(WordIndex + 1);
+    }
+
+    const uint32 NewWord = bValue ? (Bits[WordIndex] | Mask) : (Bits[WordIndex] & ~Mask);
+    if (NewWord != Bits[WordIndex])
+    {
+        Bits[WordIndex] = NewWord;
+        MarkSlotBitsDirty(Flag);
+    }
+}
+
+void ASafeZoneGameState::ClearPlayerSlot(int32 Slot)
+{
+    SetPlayerSlotFlag(Slot, ESafeZonePlayerSlotFlag::Outside, false);
+    SetPlayerSlotFlag(Slot, ESafeZonePlayerSlotFlag::Knocked, false);
+    SetPlayerSlotFlag(Slot, ESafeZonePlayerSlotFlag::Dead, false);
+}
+
+void ASafeZoneGameState::ResetMatchState()
+{
+    if (!HasAuthority())
+    {
+        return;
+    }
+
+    OutsideBits.Reset();
+    KnockedBits.Reset();
+    DeadBits.Reset();
+    MarkSlotBitsDirty(ESafeZonePlayerSlotFlag::Outside);
+    MarkSlotBitsDirty(ESafeZonePlayerSlotFlag::Knocked);
+    MarkSlotBitsDirty(ESafeZonePlayerSlotFlag::Dead);
+
+    Roster.Reset();
+    PendingCosmeticEvents.Reset();
+}
+
+bool ASafeZoneGameState::HasPlayerSlotFlag(int32 Slot, ESafeZonePlayerSlotFlag Flag) const
+{
+    const TArray<uint32>& Bits = GetSlotBits(Flag);
+    const int32 WordIndex = Slot / 32;
+    return Slot >= 0 && Bits.IsValidIndex(WordIndex) && (Bits[WordIndex] & (1u << (Slot % 32))) != 0;
+}
+
+int32 ASafeZoneGameState::GetNumPlayersWithFlag(ESafeZonePlayerSlotFlag Flag) const
+{
+    int32 Count = 0;
+    for (const uint32 Word : GetSlotBits(Flag))
+    {
+        Count += FMath::CountBits(Word);
+    }
+    return Count;
+}
+
+void ASafeZoneGameState::OnRep_PlayerSlotBits()
+{
+    OnPlayerSlotStatesChanged.Broadcast();
+}
+
+const TArray<uint32>& ASafeZoneGameState::GetSlotBits(ESafeZonePlayerSlotFlag Flag) const
+{
+    switch (Flag)
+    {
+    case ESafeZonePlayerSlotFlag::Knocked:
+        return KnockedBits;
+    case ESafeZonePlayerSlotFlag::Dead:
+        return DeadBits;
+    default:
+        return OutsideBits;
+    }
+}
+
+TArray<uint32>& ASafeZoneGameState::GetSlotBits(ESafeZonePlayerSlotFlag Flag)
+{
+    return const_cast<TArray<uint32>&>(static_cast<const ASafeZoneGameState*>(this)->GetSlotBits(Flag));
+}
+
+void ASafeZoneGameState::MarkSlotBitsDirty(ESafeZonePlayerSlotFlag Flag)
+{
+    switch (Flag)
+    {
+    case ESafeZonePlayerSlotFlag::Knocked:
+        MARK_PROPERTY_DIRTY_FROM_NAME(ASafeZoneGameState, KnockedBits, this);
+        break;
+    case ESafeZonePlayerSlotFlag::Dead:
+        MARK_PROPERTY_DIRTY_FROM_NAME(ASafeZoneGameState, DeadBits, this);
+        break;
+    default:
+        MARK_PROPERTY_DIRTY_FROM_NAME(ASafeZoneGameState, OutsideBits, this);
+        break;
+    }
+}
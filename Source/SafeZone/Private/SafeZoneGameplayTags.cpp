@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SafeZoneGameplayTags.h"
+#include "GameplayTagsManager.h"
+
+FSafeZoneGameplayTags FSafeZoneGameplayTags::GameplayTags;
+
+void FSafeZoneGameplayTags::InitializeNativeTags()
+{
+	if (GameplayTags.bInitialized)
+	{
+		return;
+	}
+
+	GameplayTags.AddTag(GameplayTags.Activation_Fail_BlockedByTags, "Activation.Fail.BlockedByTags", "Ability activation blocked by tags");
+	GameplayTags.AddTag(GameplayTags.Activation_Fail_CantAffordCost, "Activation.Fail.CantAffordCost", "Ability activation failed on its cost");
+	GameplayTags.AddTag(GameplayTags.Activation_Fail_IsDead, "Activation.Fail.IsDead", "Ability activation failed because the owner is dead");
+	GameplayTags.AddTag(GameplayTags.Activation_Fail_MissingTags, "Activation.Fail.MissingTags", "Ability activation failed on missing tags");
+	GameplayTags.AddTag(GameplayTags.Activation_Fail_Networking, "Activation.Fail.Networking", "Ability activation failed on networking");
+	GameplayTags.AddTag(GameplayTags.Activation_Fail_OnCooldown, "Activation.Fail.OnCooldown", "Ability activation failed on its cooldown");
+	GameplayTags.AddTag(GameplayTags.Data_Damage, "Data.Damage", "SetByCaller damage magnitude");
+	GameplayTags.AddTag(GameplayTags.Effect_RemoveOnDeath, "Effect.RemoveOnDeath", "Effects removed when the character dies");
+	GameplayTags.AddTag(GameplayTags.Event_EndAbility, "Event.EndAbility", "Ends the running ability");
+	GameplayTags.AddTag(GameplayTags.GameplayCue_SafeZone_Damage, "GameplayCue.SafeZone.Damage", "Zone damage tick feedback on the damaged client");
+	GameplayTags.AddTag(GameplayTags.GameplayCue_SafeZone_Entered, "GameplayCue.SafeZone.Entered", "Feedback on the client whose character got back inside the safe zone");
+	GameplayTags.AddTag(GameplayTags.GameplayCue_SafeZone_Exited, "GameplayCue.SafeZone.Exited", "Feedback on the client whose character left the safe zone");
+	GameplayTags.AddTag(GameplayTags.State_Dead, "State.Dead", "Character is dead");
+	GameplayTags.AddTag(GameplayTags.State_KnockedDown, "State.KnockedDown", "Character is knocked down");
+	GameplayTags.AddTag(GameplayTags.State_OutsideSafeZone, "State.OutsideSafeZone", "Character is outside the safe zone and takes zone damage");
+	GameplayTags.AddTag(GameplayTags.Weapon_Fail_Activation_OnCooldown, "Weapon.Fail.Activation.OnCooldown", "Weapon activation failed on its cooldown");
+
+	GameplayTags.bInitialized = true;
+}
+
+void FSafeZoneGameplayTags::AddTag(FGameplayTag& OutTag, const ANSICHAR* TagName, const ANSICHAR* TagComment)
+{
+	OutTag = UGameplayTagsManager::Get().AddNativeGameplayTag(FName(TagName), FString(TEXT("(Native) ")) + FString(TagComment));
+}
@@ -0,0 +1,317 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SafeZoneLoadTestDirector.h"
+#include "AIController.h"
+#include "Dom/JsonObject.h"
+#include "EngineUtils.h"
+#include "GameFramework/PlayerStart.h"
+#include "GamePlayerCharacter.h"
+#include "HAL/PlatformMisc.h"
+#include "Misc/App.h"
+#include "Misc/CommandLine.h"
+#include "Misc/FileHelper.h"
+#include "Misc/Paths.h"
+#include "SafeZoneActor.h"
+#include "SafeZoneGameMode.h"
+#include "Serialization/JsonSerializer.h"
+#include "Serialization/JsonWriter.h"
+
+namespace SafeZoneLoadTest
+{
+	// Seconds to let the swarm spawn and settle before frames are recorded
+	static const float WarmupSeconds = 2.0f;
+
+	// Seconds for one walk out across the boundary and back in
+	static const float BotCyclePeriod = 20.0f;
+
+	// Radians per second the walking direction of a bot rotates, so bots also move across the grid cells
+	static const float BotAngularSpeed = 0.05f;
+
+	static TSharedRef<FJsonObject> MakeDistribution(TArray<float> Samples)
+	{
+		TSharedRef<FJsonObject> Distribution = MakeShared<FJsonObject>();
+		if (Samples.Num() == 0)
+		{
+			return Distribution;
+		}
+
+		Samples.Sort();
+
+		double Sum = 0.0;
+		for (float Sample : Samples)
+		{
+			Sum += Sample;
+		}
+
+		// Nearest rank percentile
+		auto Percentile = [&Samples](float Fraction)
+		{
+			return Samples[FMath::Clamp(FMath::CeilToInt(Fraction * Samples.Num()) - 1, 0, Samples.Num() - 1)];
+		};
+
+		Distribution->SetNumberField(TEXT("avg"), Sum / Samples.Num());
+		Distribution->SetNumberField(TEXT("p50"), Percentile(0.50f));
+		Distribution->SetNumberField(TEXT("p95"), Percentile(0.95f));
+		Distribution->SetNumberField(TEXT("p99"), Percentile(0.99f));
+		Distribution->SetNumberField(TEXT("max"), Samples.Last());
+		return Distribution;
+	}
+}
+
+ASafeZoneLoadTestDirector::ASafeZoneLoadTestDirector()
+{
+	PrimaryActorTick.bCanEverTick = true;
+
+	bReplicates = false;
+
+	GameMode = nullptr;
+	NumBots = 0;
+	MaxDuration = 600.0f;
+	bExitWhenDone = true;
+	ElapsedTime = 0.0f;
+	bFinished = false;
+	bCompletedShrink = false;
+	SpawnHeight = 0.0f;
+	PlayersOutsideSum = 0.0;
+	PlayersOutsideMax = 0;
+	DamageApplicationsPerSecondSum = 0.0;
+	MembershipTransitionsPerSecondSum = 0.0;
+	DamagePassMsSum = 0.0;
+	NumBotRespawns = 0;
+}
+
+void ASafeZoneLoadTestDirector::StartFromCommandLine(ASafeZoneGameMode* InGameMode)
+{
+#if !UE_BUILD_SHIPPING
+	int32 RequestedBots = 0;
+	if (!InGameMode || !FParse::Value(FCommandLine::Get(), TEXT("SafeZoneLoadTest="), RequestedBots) || RequestedBots <= 0)
+	{
+		return;
+	}
+
+	ASafeZoneLoadTestDirector* Director = InGameMode->GetWorld()->SpawnActorDeferred<ASafeZoneLoadTestDirector>(StaticClass(), FTransform::Identity, InGameMode);
+	if (Director)
+	{
+		Director->GameMode = InGameMode;
+		Director->NumBots = RequestedBots;
+		Director->RandomStream.Initialize(RequestedBots);
+		FParse::Value(FCommandLine::Get(), TEXT("SafeZoneLoadTestMaxSeconds="), Director->MaxDuration);
+		Director->bExitWhenDone = !FParse::Param(FCommandLine::Get(), TEXT("SafeZoneLoadTestNoExit"));
+		Director->FinishSpawning(FTransform::Identity);
+	}
+#endif
+}
+
+void ASafeZoneLoadTestDirector::BeginPlay()
+{
+	Super::BeginPlay();
+
+	if (!GameMode || !GameMode->safeZoneActor_Ref)
+	{
+		UE_LOG(LogTemp, Error, TEXT("SafeZone load test: no safe zone game mode or safe zone actor in this map"));
+		FinishRun();
+		return;
+	}
+
+	SpawnHeight = GameMode->safeZoneActor_Ref->GetActorLocation().Z + 100.0f;
+	for (TActorIterator<APlayerStart> It(GetWorld()); It; ++It)
+	{
+		SpawnHeight = It->GetActorLocation().Z;
+		break;
+	}
+
+	UE_LOG(LogTemp, Display, TEXT("SafeZone load test: %d bots, at most %.0f s"), NumBots, MaxDuration);
+
+	SpawnBots();
+}
+
+void ASafeZoneLoadTestDirector::Tick(float DeltaSeconds)
+{
+	Super::Tick(DeltaSeconds);
+
+	if (bFinished)
+	{
+		return;
+	}
+
+	ElapsedTime += DeltaSeconds;
+
+	DriveBots(DeltaSeconds);
+
+	if (ElapsedTime >= SafeZoneLoadTest::WarmupSeconds)
+	{
+		RecordFrame();
+	}
+
+	if (GameMode->safeZoneActor_Ref->HasFinishedShrinking())
+	{
+		bCompletedShrink = true;
+		FinishRun();
+	}
+	else if (ElapsedTime >= MaxDuration)
+	{
+		FinishRun();
+	}
+}
+
+void ASafeZoneLoadTestDirector::SpawnBots()
+{
+	Bots.SetNum(NumBots);
+	for (int32 Index = 0; Index < Bots.Num(); ++Index)
+	{
+		FBot& Bot = Bots[Index];
+		Bot.Angle = RandomStream.FRandRange(0.0f, 2.0f * PI);
+		Bot.Phase = RandomStream.FRandRange(0.0f, 2.0f * PI);
+		SpawnBotPawn(Bot);
+	}
+}
+
+void ASafeZoneLoadTestDirector::SpawnBotPawn(FBot& Bot)
+{
+	UWorld* World = GetWorld();
+
+	FActorSpawnParameters SpawnParams;
+	SpawnParams.SpawnCollisionHandlingOverride = ESpawnActorCollisionHandlingMethod::AdjustIfPossibleButAlwaysSpawn;
+
+	if (!Bot.Controller.IsValid())
+	{
+		Bot.Controller = World->SpawnActor<AAIController>(AAIController::StaticClass(), SpawnParams);
+		if (!Bot.Controller.IsValid())
+		{
+			return;
+		}
+	}
+
+	FVector ZoneCenter;
+	float ZoneRadius;
+	GameMode->safeZoneActor_Ref->GetCurrentZone(ZoneCenter, ZoneRadius);
+
+	const FVector Direction(FMath::Cos(Bot.Angle), FMath::Sin(Bot.Angle), 0.0f);
+	const FVector Location = FVector(ZoneCenter.X, ZoneCenter.Y, SpawnHeight) + Direction * ZoneRadius * RandomStream.FRandRange(0.2f, 0.9f);
+
+	// Respawns reuse the characters of dead bots from the game mode pool
+	AGamePlayerCharacter* PlayerCharacter = GameMode->SpawnPlayerCharacter(GameMode->GetPlayerCharacterClass(), FTransform(Direction.Rotation(), Location));
+	if (!PlayerCharacter)
+	{
+		return;
+	}
+
+	// Registered like a logged in player, possession binds the character to the handle
+	GameMode->RegisterPlayerController(Bot.Controller.Get());
+	Bot.Controller->Possess(PlayerCharacter);
+}
+
+void ASafeZoneLoadTestDirector::DriveBots(float DeltaSeconds)
+{
+	FVector ZoneCenter;
+	float ZoneRadius;
+	GameMode->safeZoneActor_Ref->GetCurrentZone(ZoneCenter, ZoneRadius);
+
+	const float CycleAngle = 2.0f * PI * ElapsedTime / SafeZoneLoadTest::BotCyclePeriod;
+
+	for (FBot& Bot : Bots)
+	{
+		AAIController* Controller = Bot.Controller.Get();
+		if (!Controller)
+		{
+			continue;
+		}
+
+		AGamePlayerCharacter* PlayerCharacter = Cast<AGamePlayerCharacter>(Controller->GetPawn());
+		if (!PlayerCharacter)
+		{
+			// Died and finished dying, comes back as a fresh character like a respawning player
+			SpawnBotPawn(Bot);
+			NumBotRespawns++;
+			continue;
+		}
+
+		if (!PlayerCharacter->IsCharacterAlive())
+		{
+			continue;
+		}
+
+		// Inside for two thirds of the cycle, up to 15% beyond the boundary for the rest
+		Bot.Angle += SafeZoneLoadTest::BotAngularSpeed * DeltaSeconds;
+		const float TargetDistance = ZoneRadius * (0.85f + 0.3f * FMath::Sin(CycleAngle + Bot.Phase));
+		const FVector Target = ZoneCenter + FVector(FMath::Cos(Bot.Angle), FMath::Sin(Bot.Angle), 0.0f) * TargetDistance;
+
+		FVector ToTarget = Target - PlayerCharacter->GetActorLocation();
+		ToTarget.Z = 0.0f;
+		if (ToTarget.SizeSquared() > FMath::Square(50.0f))
+		{
+			PlayerCharacter->AddMovementInput(ToTarget.GetSafeNormal());
+		}
+	}
+}
+
+void ASafeZoneLoadTestDirector::RecordFrame()
+{
+	const float FrameMs = FApp::GetDeltaTime() * 1000.0f;
+	const float IdleMs = FApp::GetIdleTime() * 1000.0f;
+	FrameTimesMs.Add(FrameMs);
+	FrameWorkTimesMs.Add(FMath::Max(FrameMs - IdleMs, 0.0f));
+
+	const int32 PlayersOutside = GameMode->GetNumPlayersOutside();
+	PlayersOutsideSum += PlayersOutside;
+	PlayersOutsideMax = FMath::Max(PlayersOutsideMax, PlayersOutside);
+	DamageApplicationsPerSecondSum += GameMode->GetDamageApplicationsPerSecond();
+	MembershipTransitionsPerSecondSum += GameMode->GetMembershipTransitionsPerSecond();
+	DamagePassMsSum += GameMode->GetAverageZoneDamagePassMs();
+}
+
+void ASafeZoneLoadTestDirector::FinishRun()
+{
+	bFinished = true;
+	SetActorTickEnabled(false);
+
+	WriteReport();
+
+	if (bExitWhenDone)
+	{
+		FPlatformMisc::RequestExit(false);
+	}
+}
+
+void ASafeZoneLoadTestDirector::WriteReport() const
+{
+	const int32 NumFrames = FrameTimesMs.Num();
+	const double FrameDivisor = FMath::Max(NumFrames, 1);
+
+	TSharedRef<FJsonObject> Stats = MakeShared<FJsonObject>();
+	Stats->SetNumberField(TEXT("playersOutsideAvg"), PlayersOutsideSum / FrameDivisor);
+	Stats->SetNumberField(TEXT("playersOutsideMax"), PlayersOutsideMax);
+	Stats->SetNumberField(TEXT("damageApplicationsPerSecondAvg"), DamageApplicationsPerSecondSum / FrameDivisor);
+	Stats->SetNumberField(TEXT("membershipTransitionsPerSecondAvg"), MembershipTransitionsPerSecondSum / FrameDivisor);
+	Stats->SetNumberField(TEXT("damagePassMsAvg"), DamagePassMsSum / FrameDivisor);
+	Stats->SetNumberField(TEXT("matchStartInitSeconds"), GameMode->GetMatchStartInitSeconds());
+
+	TSharedRef<FJsonObject> Report = MakeShared<FJsonObject>();
+	Report->SetNumberField(TEXT("version"), 1);
+	Report->SetStringField(TEXT("map"), GetWorld()->GetMapName());
+	Report->SetStringField(TEXT("buildConfiguration"), LexToString(FApp::GetBuildConfiguration()));
+	Report->SetStringField(TEXT("timestamp"), FDateTime::UtcNow().ToIso8601());
+	Report->SetNumberField(TEXT("bots"), NumBots);
+	Report->SetNumberField(TEXT("botRespawns"), NumBotRespawns);
+	Report->SetBoolField(TEXT("completedShrink"), bCompletedShrink);
+	Report->SetNumberField(TEXT("durationSeconds"), ElapsedTime);
+	Report->SetNumberField(TEXT("frames"), NumFrames);
+	Report->SetObjectField(TEXT("frameTimeMs"), SafeZoneLoadTest::MakeDistribution(FrameTimesMs));
+	Report->SetObjectField(TEXT("frameWorkTimeMs"), SafeZoneLoadTest::MakeDistribution(FrameWorkTimesMs));
+	Report->SetObjectField(TEXT("stats"), Stats);
+
+	FString Json;
+	TSharedRef<TJsonWriter<>> Writer = TJsonWriterFactory<>::Create(&Json);
+	FJsonSerializer::Serialize(Report, Writer);
+
+	const FString ReportPath = FPaths::ProfilingDir() / TEXT("SafeZone") / FString::Printf(TEXT("LoadTest-%d-%s.json"), NumBots, *FDateTime::Now().ToString());
+	if (FFileHelper::SaveStringToFile(Json, *ReportPath))
+	{
+		UE_LOG(LogTemp, Display, TEXT("SafeZone load test: report written to %s"), *ReportPath);
+	}
+	else
+	{
+		UE_LOG(LogTemp, Error, TEXT("SafeZone load test: could not write %s"), *ReportPath);
+	}
+}
@@ -0,0 +1,122 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SafeZoneMembership.h"
+
+FSafeZoneMembershipBatch::FSafeZoneMembershipBatch()
+{
+}
+
+void FSafeZoneMembershipBatch::Reset()
+{
+	PositionX.Reset();
+	PositionY.Reset();
+}
+
+int32 FSafeZoneMembershipBatch::Add(const FVector& Position)
+{
+	PositionX.Add(Position.X);
+	return PositionY.Add(Position.Y);
+}
+
+void FSafeZoneMembershipBatch::TestCircle(const FVector2D& Center, float Radius, TArray<uint8>& OutInside) const
+{
+	OutInside.SetNumUninitialized(Num(), false);
+	TestCircle(PositionX.GetData(), PositionY.GetData(), Num(), Center, Radius, OutInside.GetData());
+}
+
+void FSafeZoneMembershipBatch::TestCircle(const float* InPositionX, const float* InPositionY, int32 NumPositions, const FVector2D& Center, float Radius, uint8* OutInside)
+{
+	check(IsAligned(InPositionX, 16) && IsAligned(InPositionY, 16));
+
+	const float RadiusSquared = FMath::Square(FMath::Max(Radius, 0.0f));
+
+	const VectorRegister CenterX = VectorSetFloat1(Center.X);
+	const VectorRegister CenterY = VectorSetFloat1(Center.Y);
+	const VectorRegister RadiusSq = VectorSetFloat1(RadiusSquared);
+
+	int32 Index = 0;
+	for (; Index + 4 <= NumPositions; Index += 4)
+	{
+		const VectorRegister DeltaX = VectorSubtract(VectorLoadAligned(InPositionX + Index), CenterX);
+		const VectorRegister DeltaY = VectorSubtract(VectorLoadAligned(InPositionY + Index), CenterY);
+		const VectorRegister DistanceSq = VectorMultiplyAdd(DeltaX, DeltaX, VectorMultiply(DeltaY, DeltaY));
+		const int32 Mask = VectorMaskBits(VectorCompareLE(DistanceSq, RadiusSq));
+
+		OutInside[Index + 0] = (Mask >> 0) & 1;
+		OutInside[Index + 1] = (Mask >> 1) & 1;
+		OutInside[Index + 2] = (Mask >> 2) & 1;
+		OutInside[Index + 3] = (Mask >> 3) & 1;
+	}
+
+	// Remaining positions that don't fill a whole register
+	for (; Index < NumPositions; ++Index)
+	{
+		const float DeltaX = InPositionX[Index] - Center.X;
+		const float DeltaY = InPositionY[Index] - Center.Y;
+		OutInside[Index] = (DeltaX * DeltaX + DeltaY * DeltaY) <= RadiusSquared ? 1 : 0;
+	}
+}
+
+void FSafeZoneMembershipBatch::TestCircles(const TArray<FVector2D>& Centers, const TArray<float>& Radii, TArray<uint32>& OutMasks) const
+{
+	check(Centers.Num() == Radii.Num());
+
+	OutMasks.SetNumUninitialized(Num(), false);
+	TestCircles(PositionX.GetData(), PositionY.GetData(), Num(), Centers.GetData(), Radii.GetData(), Centers.Num(), OutMasks.GetData());
+}
+
+void FSafeZoneMembershipBatch::TestCircles(const float* InPositionX, const float* InPositionY, int32 NumPositions, const FVector2D* Centers, const float* Radii, int32 NumCircles, uint32* OutMasks)
+{
+	check(NumCircles <= MaxCircles);
+	check(IsAligned(InPositionX, 16) && IsAligned(InPositionY, 16));
+
+	float RadiiSquared[MaxCircles];
+	for (int32 Circle = 0; Circle < NumCircles; ++Circle)
+	{
+		RadiiSquared[Circle] = FMath::Square(FMath::Max(Radii[Circle], 0.0f));
+	}
+
+	// Positions are loaded once per group of four, the circles are looped while they are in registers
+	int32 Index = 0;
+	for (; Index + 4 <= NumPositions; Index += 4)
+	{
+		const VectorRegister X = VectorLoadAligned(InPositionX + Index);
+		const VectorRegister Y = VectorLoadAligned(InPositionY + Index);
+
+		uint32 Mask0 = 0;
+		uint32 Mask1 = 0;
+		uint32 Mask2 = 0;
+		uint32 Mask3 = 0;
+		for (int32 Circle = 0; Circle < NumCircles; ++Circle)
+		{
+			const VectorRegister DeltaX = VectorSubtract(X, VectorSetFloat1(Centers[Circle].X));
+			const VectorRegister DeltaY = VectorSubtract(Y, VectorSetFloat1(Centers[Circle].Y));
+			const VectorRegister DistanceSq = VectorMultiplyAdd(DeltaX, DeltaX, VectorMultiply(DeltaY, DeltaY));
+			const uint32 Inside = (uint32)VectorMaskBits(VectorCompareLE(DistanceSq, VectorSetFloat1(RadiiSquared[Circle])));
+
+			Mask0 |= ((Inside >> 0) & 1) << Circle;
+			Mask1 |= ((Inside >> 1) & 1) << Circle;
+			Mask2 |= ((Inside >> 2) & 1) << Circle;
+			Mask3 |= ((Inside >> 3) & 1) << Circle;
+		}
+
+		OutMasks[Index + 0] = Mask0;
+		OutMasks[Index + 1] = Mask1;
+		OutMasks[Index + 2] = Mask2;
+		OutMasks[Index + 3] = Mask3;
+	}
+
+	// Remaining positions that don't fill a whole register
+	for (; Index < NumPositions; ++Index)
+	{
+		uint32 Mask = 0;
+		for (int32 Circle = 0; Circle < NumCircles; ++Circle)
+		{
+			const float DeltaX = InPositionX[Index] - Centers[Circle].X;
+			const float DeltaY = InPositionY[Index] - Centers[Circle].Y;
+			Mask |= ((DeltaX * DeltaX + DeltaY * DeltaY) <= RadiiSquared[Circle] ? 1u : 0u) << Circle;
+		}
+		OutMasks[Index] = Mask;
+	}
+}
\ No newline at end of file
@@ -0,0 +1,273 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SafeZonePlayerGrid.h"
+
+FSafeZonePlayerGrid::FSafeZonePlayerGrid()
+	: Origin(FVector2D::ZeroVector)
+	, CellSize(1.0f)
+	, NumCellsX(0)
+	, NumCellsY(0)
+	, NumItems(0)
+{
+}
+
+void FSafeZonePlayerGrid::Initialize(const FVector2D& Center, float HalfExtent, float InCellSize)
+{
+	CellSize = FMath::Max(InCellSize, 1.0f);
+	NumCellsX = FMath::Max(FMath::CeilToInt(2.0f * HalfExtent / CellSize), 1);
+	NumCellsY = NumCellsX;
+	Origin = Center - FVector2D(NumCellsX * CellSize, NumCellsY * CellSize) * 0.5f;
+
+	CellHeads.Init(INDEX_NONE, NumCellsX * NumCellsY);
+	CellCounts.Init(0, NumCellsX * NumCellsY);
+
+	ItemPositions.Reset();
+	ItemCells.Reset();
+	ItemNext.Reset();
+	ItemPrev.Reset();
+	FreeItemIds.Reset();
+	NumItems = 0;
+}
+
+int32 FSafeZonePlayerGrid::AddItem(const FVector2D& Position)
+{
+	check(IsInitialized());
+
+	int32 ItemId;
+	if (FreeItemIds.Num() > 0)
+	{
+		ItemId = FreeItemIds.Pop(false);
+	}
+	else
+	{
+		ItemId = ItemPositions.AddUninitialized();
+		ItemCells.AddUninitialized();
+		ItemNext.AddUninitialized();
+		ItemPrev.AddUninitialized();
+	}
+
+	ItemPositions[ItemId] = Position;
+	LinkItem(ItemId, GetCellIndex(Position));
+	NumItems++;
+
+	return ItemId;
+}
+
+void FSafeZonePlayerGrid::MoveItem(int32 ItemId, const FVector2D& Position)
+{
+	check(ItemCells.IsValidIndex(ItemId) && ItemCells[ItemId] != INDEX_NONE);
+
+	ItemPositions[ItemId] = Position;
+
+	const int32 CellIndex = GetCellIndex(Position);
+	if (CellIndex != ItemCells[ItemId])
+	{
+		UnlinkItem(ItemId);
+		LinkItem(ItemId, CellIndex);
+	}
+}
+
+void FSafeZonePlayerGrid::RemoveItem(int32 ItemId)
+{
+	if (!ItemCells.IsValidIndex(ItemId) || ItemCells[ItemId] == INDEX_NONE)
+	{
+		return;
+	}
+
+	UnlinkItem(ItemId);
+	ItemCells[ItemId] = INDEX_NONE;
+	FreeItemIds.Add(ItemId);
+	NumItems--;
+}
+
+int32 FSafeZonePlayerGrid::CountInRect(const FBox2D& Rect) const
+{
+	int32 MinX, MinY, MaxX, MaxY;
+	GetCellRange(Rect, MinX, MinY, MaxX, MaxY);
+
+	int32 Count = 0;
+	for (int32 CellY = MinY; CellY <= MaxY; ++CellY)
+	{
+		for (int32 CellX = MinX; CellX <= MaxX; ++CellX)
+		{
+			const int32 CellIndex = CellY * NumCellsX + CellX;
+			const FVector2D CellMin = Origin + FVector2D(CellX * CellSize, CellY * CellSize);
+			const FBox2D CellBox(CellMin, CellMin + FVector2D(CellSize, CellSize));
+
+			// Cells fully covered by the rectangle are counted without looking at their items
+			if (Rect.IsInside(CellBox.Min) && Rect.IsInside(CellBox.Max) && CellX > 0 && CellY > 0 && CellX < NumCellsX - 1 && CellY < NumCellsY - 1)
+			{
+				Count += CellCounts[CellIndex];
+				continue;
+			}
+
+			for (int32 ItemId = CellHeads[CellIndex]; ItemId != INDEX_NONE; ItemId = ItemNext[ItemId])
+			{
+				if (Rect.IsInside(ItemPositions[ItemId]))
+				{
+					Count++;
+				}
+			}
+		}
+	}
+
+	return Count;
+}
+
+int32 FSafeZonePlayerGrid::CountInRadius(const FVector2D& Center, float Radius) const
+{
+	int32 MinX, MinY, MaxX, MaxY;
+	GetCellRange(FBox2D(Center - FVector2D(Radius, Radius), Center + FVector2D(Radius, Radius)), MinX, MinY, MaxX, MaxY);
+
+	const float RadiusSquared = FMath::Square(Radius);
+
+	int32 Count = 0;
+	for (int32 CellY = MinY; CellY <= MaxY; ++CellY)
+	{
+		for (int32 CellX = MinX; CellX <= MaxX; ++CellX)
+		{
+			const int32 CellIndex = CellY * NumCellsX + CellX;
+			for (int32 ItemId = CellHeads[CellIndex]; ItemId != INDEX_NONE; ItemId = ItemNext[ItemId])
+			{
+				if (FVector2D::DistSquared(ItemPositions[ItemId], Center) <= RadiusSquared)
+				{
+					Count++;
+				}
+			}
+		}
+	}
+
+	return Count;
+}
+
+void FSafeZonePlayerGrid::GetItemsInRadius(const FVector2D& Center, float Radius, TArray<int32>& OutItemIds) const
+{
+	OutItemIds.Reset();
+
+	int32 MinX, MinY, MaxX, MaxY;
+	GetCellRange(FBox2D(Center - FVector2D(Radius, Radius), Center + FVector2D(Radius, Radius)), MinX, MinY, MaxX, MaxY);
+
+	const float RadiusSquared = FMath::Square(Radius);
+
+	for (int32 CellY = MinY; CellY <= MaxY; ++CellY)
+	{
+		for (int32 CellX = MinX; CellX <= MaxX; ++CellX)
+		{
+			const int32 CellIndex = CellY * NumCellsX + CellX;
+			for (int32 ItemId = CellHeads[CellIndex]; ItemId != INDEX_NONE; ItemId = ItemNext[ItemId])
+			{
+				if (FVector2D::DistSquared(ItemPositions[ItemId], Center) <= RadiusSquared)
+				{
+					OutItemIds.Add(ItemId);
+				}
+			}
+		}
+	}
+}
+
+FVector2D FSafeZonePlayerGrid::FindLeastPopulatedRegion(const FVector2D& SearchCenter, float SearchRadius, float RegionRadius) const
+{
+	if (!IsInitialized())
+	{
+		return SearchCenter;
+	}
+
+	// The region has to stay inside the search circle
+	const float MaxOffset = FMath::Max(SearchRadius - RegionRadius, 0.0f);
+	const float MaxOffsetSquared = FMath::Square(MaxOffset);
+
+	int32 MinX, MinY, MaxX, MaxY;
+	GetCellRange(FBox2D(SearchCenter - FVector2D(MaxOffset, MaxOffset), SearchCenter + FVector2D(MaxOffset, MaxOffset)), MinX, MinY, MaxX, MaxY);
+
+	FVector2D BestCenter = SearchCenter;
+	int32 BestCount = CountInRadius(SearchCenter, RegionRadius);
+	int32 NumTies = 1;
+
+	for (int32 CellY = MinY; CellY <= MaxY; ++CellY)
+	{
+		for (int32 CellX = MinX; CellX <= MaxX; ++CellX)
+		{
+			const FVector2D Candidate = GetCellCenter(CellX, CellY);
+			if (FVector2D::DistSquared(Candidate, SearchCenter) > MaxOffsetSquared)
+			{
+				continue;
+			}
+
+			const int32 Count = CountInRadius(Candidate, RegionRadius);
+			if (Count < BestCount)
+			{
+				BestCount = Count;
+				BestCenter = Candidate;
+				NumTies = 1;
+			}
+			else if (Count == BestCount && FMath::RandRange(0, NumTies++) == 0)
+			{
+				// Reservoir sampling keeps every tied candidate equally likely
+				BestCenter = Candidate;
+			}
+		}
+	}
+
+	return BestCenter;
+}
+
+int32 FSafeZonePlayerGrid::GetCellIndex(const FVector2D& Position) const
+{
+	// Positions outside the grid are kept in the border cells
+	const int32 CellX = FMath::Clamp(FMath::FloorToInt((Position.X - Origin.X) / CellSize), 0, NumCellsX - 1);
+	const int32 CellY = FMath::Clamp(FMath::FloorToInt((Position.Y - Origin.Y) / CellSize), 0, NumCellsY - 1);
+	return CellY * NumCellsX + CellX;
+}
+
+void FSafeZonePlayerGrid::GetCellRange(const FBox2D& Rect, int32& OutMinX, int32& OutMinY, int32& OutMaxX, int32& OutMaxY) const
+{
+	OutMinX = FMath::Clamp(FMath::FloorToInt((Rect.Min.X - Origin.X) / CellSize), 0, NumCellsX - 1);
+	OutMinY = FMath::Clamp(FMath::FloorToInt((Rect.Min.Y - Origin.Y) / CellSize), 0, NumCellsY - 1);
+	OutMaxX = FMath::Clamp(FMath::FloorToInt((Rect.Max.X - Origin.X) / CellSize), 0, NumCellsX - 1);
+	OutMaxY = FMath::Clamp(FMath::FloorToInt((Rect.Max.Y - Origin.Y) / CellSize), 0, NumCellsY - 1);
+}
+
+FVector2D FSafeZonePlayerGrid::GetCellCenter(int32 CellX, int32 CellY) const
+{
+	return Origin + FVector2D((CellX + 0.5f) * CellSize, (CellY + 0.5f) * CellSize);
+}
+
+void FSafeZonePlayerGrid::LinkItem(int32 ItemId, int32 CellIndex)
+{
+	const int32 Head = CellHeads[CellIndex];
+
+	ItemCells[ItemId] = CellIndex;
+	ItemPrev[ItemId] = INDEX_NONE;
+	ItemNext[ItemId] = Head;
+	if (Head != INDEX_NONE)
+	{
+		ItemPrev[Head] = ItemId;
+	}
+
+	CellHeads[CellIndex] = ItemId;
+	CellCounts[CellIndex]++;
+}
+
+void FSafeZonePlayerGrid::UnlinkItem(int32 ItemId)
+{
+	const int32 CellIndex = ItemCells[ItemId];
+	const int32 Prev = ItemPrev[ItemId];
+	const int32 Next = ItemNext[ItemId];
+
+	if (Prev != INDEX_NONE)
+	{
+		ItemNext[Prev] = Next;
+	}
+	else
+	{
+		CellHeads[CellIndex] = Next;
+	}
+
+	if (Next != INDEX_NONE)
+	{
+		ItemPrev[Next] = Prev;
+	}
+
+	CellCounts[CellIndex]--;
+}
@@ -0,0 +1,133 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SafeZonePlayerRegistry.h"
+#include "GameFramework/Controller.h"
+#include "GameFramework/PlayerState.h"
+#include "GamePlayerCharacter.h"
+
+FSafeZonePlayerRegistry::FSafeZonePlayerRegistry()
+	: NumPlayers(0)
+{
+}
+
+int32 FSafeZonePlayerRegistry::AllocateHandle(AController* Controller)
+{
+	check(Controller);
+
+	if (const int32* ExistingHandle = ControllerHandles.Find(Controller))
+	{
+		return *ExistingHandle;
+	}
+
+	int32 Handle;
+	if (FreeHandles.Num() > 0)
+	{
+		Handle = FreeHandles.Pop(false);
+	}
+	else
+	{
+		Handle = Flags.AddUninitialized();
+		Controllers.AddDefaulted();
+		Characters.AddDefaulted();
+		Positions.AddUninitialized();
+		ZoneStates.AddUninitialized();
+		GraceEndTimes.AddUninitialized();
+		Healths.AddUninitialized();
+		Quadrants.AddUninitialized();
+	}
+
+	ResetSlot(Handle);
+	Flags[Handle] = Flag_InUse;
+	Controllers[Handle] = Controller;
+	ControllerHandles.Add(Controller, Handle);
+	NumPlayers++;
+
+	return Handle;
+}
+
+void FSafeZonePlayerRegistry::FreeHandle(int32 Handle)
+{
+	if (!IsValidHandle(Handle))
+	{
+		return;
+	}
+
+	ControllerHandles.Remove(Controllers[Handle].Get());
+	ResetSlot(Handle);
+	FreeHandles.Add(Handle);
+	NumPlayers--;
+}
+
+void FSafeZonePlayerRegistry::Reset()
+{
+	Controllers.Reset();
+	Characters.Reset();
+	Positions.Reset();
+	ZoneStates.Reset();
+	GraceEndTimes.Reset();
+	Healths.Reset();
+	Flags.Reset();
+	Quadrants.Reset();
+	FreeHandles.Reset();
+	ControllerHandles.Reset();
+	NumPlayers = 0;
+}
+
+int32 FSafeZonePlayerRegistry::FindHandle(const AController* Controller) const
+{
+	const int32* Handle = ControllerHandles.Find(Controller);
+	return Handle ? *Handle : INDEX_NONE;
+}
+
+int32 FSafeZonePlayerRegistry::FindHandleByPlayerId(const FString& PlayerId) const
+{
+	for (int32 Handle = 0; Handle < Flags.Num(); ++Handle)
+	{
+		if (IsValidHandle(Handle) && GetPlayerId(Handle) == PlayerId)
+		{
+			return Handle;
+		}
+	}
+	return INDEX_NONE;
+}
+
+FString FSafeZonePlayerRegistry::GetPlayerId(int32 Handle) const
+{
+	const AController* Controller = IsValidHandle(Handle) ? Controllers[Handle].Get() : nullptr;
+	if (Controller && Controller->PlayerState)
+	{
+		return Controller->PlayerState->GetUniqueId().ToString();
+	}
+	return FString();
+}
+
+void FSafeZonePlayerRegistry::BindCharacter(int32 Handle, AGamePlayerCharacter* PlayerCharacter, float Health)
+{
+	if (!IsValidHandle(Handle))
+	{
+		return;
+	}
+
+	Characters[Handle] = PlayerCharacter;
+	Positions[Handle] = PlayerCharacter ? PlayerCharacter->GetActorLocation() : FVector::ZeroVector;
+	// Treated as inside until the first membership pass, so players spawning outside get an exit
+	ZoneStates[Handle] = ESafeZonePlayerZoneState::Inside;
+	GraceEndTimes[Handle] = 0.0f;
+	Healths[Handle] = Health;
+	Quadrants[Handle] = INDEX_NONE;
+	SetAlive(Handle, PlayerCharacter != nullptr);
+	SetKnocked(Handle, false);
+}
+
+void FSafeZonePlayerRegistry::ResetSlot(int32 Handle)
+{
+	Controllers[Handle] = nullptr;
+	Characters[Handle] = nullptr;
+	Positions[Handle] = FVector::ZeroVector;
+	ZoneStates[Handle] = ESafeZonePlayerZoneState::Inside;
+	GraceEndTimes[Handle] = 0.0f;
+	Healths[Handle] = 0.0f;
+	Flags[Handle] = 0;
+	Quadrants[Handle] = INDEX_NONE;
+}
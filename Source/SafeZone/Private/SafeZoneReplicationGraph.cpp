@@ -0,0 +1,263 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SafeZoneReplicationGraph.h"
+#include "Engine/LevelScriptActor.h"
+#include "Engine/NetConnection.h"
+#include "GameFramework/GameStateBase.h"
+#include "GameFramework/PlayerController.h"
+#include "GameFramework/PlayerState.h"
+#include "GamePlayerCharacter.h"
+#include "QuadrantSystemActor.h"
+#include "SafeZoneActor.h"
+#include "SafeZoneStats.h"
+
+USafeZoneReplicationGraph::USafeZoneReplicationGraph()
+{
+	GridNode = nullptr;
+	AlwaysRelevantNode = nullptr;
+	DistanceThrottleNode = nullptr;
+
+	GridCellSize = 10000.0f;
+	SpatialBiasX = -150000.0f;
+	SpatialBiasY = -200000.0f;
+
+	ThrottleNearDistance = 5000.0f;
+	ThrottleFarDistance = 10000.0f;
+	ThrottleMidPeriodScale = 2;
+	ThrottleFarPeriodScale = 4;
+}
+
+void USafeZoneReplicationGraph::InitGlobalActorClassSettings()
+{
+	Super::InitGlobalActorClassSettings();
+
+	// Explicit routing for the project classes, their subclasses (blueprints included) inherit it
+	TArray<UClass*> ExplicitClasses;
+	auto SetExplicitPolicy = [this, &ExplicitClasses](UClass* Class, ESafeZoneClassRepNodeMapping Mapping)
+	{
+		ClassRepNodePolicies.Set(Class, Mapping);
+		ExplicitClasses.Add(Class);
+	};
+
+	SetExplicitPolicy(AGamePlayerCharacter::StaticClass(), ESafeZoneClassRepNodeMapping::Spatialize_Dynamic);
+	SetExplicitPolicy(ASafeZoneActor::StaticClass(), ESafeZoneClassRepNodeMapping::RelevantAllConnections);
+	SetExplicitPolicy(AGameStateBase::StaticClass(), ESafeZoneClassRepNodeMapping::RelevantAllConnections);
+	// Server side helpers
+	SetExplicitPolicy(AQuadrantSystemActor::StaticClass(), ESafeZoneClassRepNodeMapping::NotRouted);
+	SetExplicitPolicy(AReplicationGraphDebugActor::StaticClass(), ESafeZoneClassRepNodeMapping::NotRouted);
+	SetExplicitPolicy(ALevelScriptActor::StaticClass(), ESafeZoneClassRepNodeMapping::NotRouted);
+	// Gathered by the per connection and player state nodes
+	SetExplicitPolicy(APlayerController::StaticClass(), ESafeZoneClassRepNodeMapping::NotRouted);
+	SetExplicitPolicy(APlayerState::StaticClass(), ESafeZoneClassRepNodeMapping::NotRouted);
+
+	const float ServerMaxTickRate = NetDriver ? NetDriver->NetServerMaxTickRate : 30.0f;
+
+	for (TObjectIterator<UClass> It; It; ++It)
+	{
+		UClass* Class = *It;
+		AActor* ActorCDO = Cast<AActor>(Class->GetDefaultObject());
+		if (!ActorCDO || !ActorCDO->GetIsReplicated())
+		{
+			continue;
+		}
+
+		// Blueprint compilation leftovers
+		if (Class->GetName().StartsWith(TEXT("SKEL_")) || Class->GetName().StartsWith(TEXT("REINST_")))
+		{
+			continue;
+		}
+
+		const bool bExplicit = ExplicitClasses.ContainsByPredicate([Class](const UClass* ExplicitClass) { return Class->IsChildOf(ExplicitClass); });
+		if (!bExplicit)
+		{
+			// Everything else follows its default relevancy flags
+			ESafeZoneClassRepNodeMapping Mapping = ESafeZoneClassRepNodeMapping::NotRouted;
+			if (ActorCDO->bAlwaysRelevant && !ActorCDO->bOnlyRelevantToOwner)
+			{
+				Mapping = ESafeZoneClassRepNodeMapping::RelevantAllConnections;
+			}
+			else if (!ActorCDO->bAlwaysRelevant && !ActorCDO->bOnlyRelevantToOwner && !ActorCDO->bNetUseOwnerRelevancy)
+			{
+				Mapping = ActorCDO->NetDormancy > DORM_Awake ? ESafeZoneClassRepNodeMapping::Spatialize_Dormancy : ESafeZoneClassRepNodeMapping::Spatialize_Dynamic;
+			}
+			ClassRepNodePolicies.Set(Class, Mapping);
+		}
+
+		const ESafeZoneClassRepNodeMapping Mapping = GetMappingPolicy(Class);
+
+		FClassReplicationInfo ClassInfo;
+		if (Mapping >= ESafeZoneClassRepNodeMapping::Spatialize_Static)
+		{
+			ClassInfo.SetCullDistanceSquared(ActorCDO->NetCullDistanceSquared);
+		}
+		ClassInfo.ReplicationPeriodFrame = FMath::Max<uint32>((uint32)FMath::RoundToFloat(ServerMaxTickRate / FMath::Max(ActorCDO->NetUpdateFrequency, 1.0f)), 1);
+		GlobalActorReplicationInfoMap.SetClassInfo(Class, ClassInfo);
+	}
+}
+
+void USafeZoneReplicationGraph::InitGlobalGraphNodes()
+{
+	GridNode = CreateNewNode<UReplicationGraphNode_GridSpatialization2D>();
+	GridNode->CellSize = GridCellSize;
+	GridNode->SpatialBias = FVector2D(SpatialBiasX, SpatialBiasY);
+	AddGlobalGraphNode(GridNode);
+
+	AlwaysRelevantNode = CreateNewNode<UReplicationGraphNode_ActorList>();
+	AddGlobalGraphNode(AlwaysRelevantNode);
+
+	// Player states replicate a limited number per frame instead of all of them every frame
+	AddGlobalGraphNode(CreateNewNode<UReplicationGraphNode_PlayerStateFrequencyLimiter>());
+
+	// The grid culls characters past their net cull distance, a band starting there would never apply
+	const float CharacterCullDistance = FMath::Sqrt(GetDefault<AGamePlayerCharacter>()->NetCullDistanceSquared);
+	float FarDistance = FMath::Max(ThrottleFarDistance, ThrottleNearDistance);
+	if (FarDistance >= CharacterCullDistance)
+	{
+		FarDistance = CharacterCullDistance * 0.75f;
+		UE_LOG(LogTemp, Warning, TEXT("SafeZoneReplicationGraph: ThrottleFarDistance %.0f is past the character net cull distance %.0f, using %.0f"), ThrottleFarDistance, CharacterCullDistance, FarDistance);
+	}
+
+	DistanceThrottleNode = CreateNewNode<USafeZoneReplicationGraphNode_DistanceThrottle>();
+	DistanceThrottleNode->NearDistance = FMath::Min(ThrottleNearDistance, FarDistance);
+	DistanceThrottleNode->FarDistance = FarDistance;
+	DistanceThrottleNode->MidPeriodScale = FMath::Max(ThrottleMidPeriodScale, 1);
+	DistanceThrottleNode->FarPeriodScale = FMath::Max(ThrottleFarPeriodScale, 1);
+	AddGlobalGraphNode(DistanceThrottleNode);
+}
+
+void USafeZoneReplicationGraph::InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection)
+{
+	Super::InitConnectionGraphNodes(RepGraphConnection);
+
+	// The connection's own controller, view target and pawn
+	AddConnectionGraphNode(CreateNewNode<UReplicationGraphNode_AlwaysRelevant_ForConnection>(), RepGraphConnection);
+}
+
+void USafeZoneReplicationGraph::RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case ESafeZoneClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyAddNetworkActor(ActorInfo);
+		break;
+	case ESafeZoneClassRepNodeMapping::Spatialize_Static:
+		GridNode->AddActor_Static(ActorInfo, GlobalInfo);
+		break;
+	case ESafeZoneClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->AddActor_Dynamic(ActorInfo, GlobalInfo);
+		break;
+	case ESafeZoneClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->AddActor_Dormancy(ActorInfo, GlobalInfo);
+		break;
+	default:
+		break;
+	}
+
+	if (ActorInfo.Class->IsChildOf(AGamePlayerCharacter::StaticClass()))
+	{
+		DistanceThrottleNode->NotifyAddNetworkActor(ActorInfo);
+	}
+}
+
+void USafeZoneReplicationGraph::RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo)
+{
+	switch (GetMappingPolicy(ActorInfo.Class))
+	{
+	case ESafeZoneClassRepNodeMapping::RelevantAllConnections:
+		AlwaysRelevantNode->NotifyRemoveNetworkActor(ActorInfo);
+		break;
+	case ESafeZoneClassRepNodeMapping::Spatialize_Static:
+		GridNode->RemoveActor_Static(ActorInfo);
+		break;
+	case ESafeZoneClassRepNodeMapping::Spatialize_Dynamic:
+		GridNode->RemoveActor_Dynamic(ActorInfo);
+		break;
+	case ESafeZoneClassRepNodeMapping::Spatialize_Dormancy:
+		GridNode->RemoveActor_Dormancy(ActorInfo);
+		break;
+	default:
+		break;
+	}
+
+	if (ActorInfo.Class->IsChildOf(AGamePlayerCharacter::StaticClass()))
+	{
+		DistanceThrottleNode->NotifyRemoveNetworkActor(ActorInfo);
+	}
+}
+
+ESafeZoneClassRepNodeMapping USafeZoneReplicationGraph::GetMappingPolicy(UClass* Class)
+{
+	ESafeZoneClassRepNodeMapping* Policy = ClassRepNodePolicies.Get(Class);
+	return Policy ? *Policy : ESafeZoneClassRepNodeMapping::NotRouted;
+}
+
+USafeZoneReplicationGraphNode_DistanceThrottle::USafeZoneReplicationGraphNode_DistanceThrottle()
+{
+	NearDistance = 5000.0f;
+	FarDistance = 15000.0f;
+	MidPeriodScale = 2;
+	FarPeriodScale = 4;
+	UpdateInterval = 4;
+}
+
+void USafeZoneReplicationGraphNode_DistanceThrottle::NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo)
+{
+	Characters.PrepareForWrite();
+	Characters.Add(ActorInfo.Actor);
+}
+
+bool USafeZoneReplicationGraphNode_DistanceThrottle::NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound)
+{
+	return Characters.Remove(ActorInfo.Actor);
+}
+
+void USafeZoneReplicationGraphNode_DistanceThrottle::NotifyResetAllNetworkActors()
+{
+	Characters.Reset();
+}
+
+void USafeZoneReplicationGraphNode_DistanceThrottle::GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params)
+{
+	// Periods only need to follow the viewer loosely, each connection refreshes on its own frame
+	if ((Params.ReplicationFrameNum + Params.ConnectionManager.ConnectionOrderNum) % UpdateInterval != 0 || Params.Viewers.Num() == 0)
+	{
+		return;
+	}
+
+	const float NearDistanceSquared = FMath::Square(NearDistance);
+	const float FarDistanceSquared = FMath::Square(FarDistance);
+
+	int32 NumMid = 0;
+	int32 NumFar = 0;
+
+	for (FActorRepListType Actor : Characters)
+	{
+		const FVector ActorLocation = Actor->GetActorLocation();
+
+		float DistanceSquared = TNumericLimits<float>::Max();
+		for (const FNetViewer& Viewer : Params.Viewers)
+		{
+			DistanceSquared = FMath::Min(DistanceSquared, FVector::DistSquared2D(Viewer.ViewLocation, ActorLocation));
+		}
+
+		int32 PeriodScale = 1;
+		if (DistanceSquared > FarDistanceSquared)
+		{
+			PeriodScale = FarPeriodScale;
+			NumFar++;
+		}
+		else if (DistanceSquared > NearDistanceSquared)
+		{
+			PeriodScale = MidPeriodScale;
+			NumMid++;
+		}
+
+		const FGlobalActorReplicationInfo& GlobalInfo = GraphGlobals->GlobalActorReplicationInfoMap->Get(Actor);
+		FConnectionReplicationActorInfo& ConnectionInfo = Params.ConnectionManager.ActorInfoMap.FindOrAdd(Actor);
+		ConnectionInfo.ReplicationPeriodFrame = GlobalInfo.Settings.ReplicationPeriodFrame * PeriodScale;
+	}
+
+	INC_DWORD_STAT_BY(STAT_SafeZone_NetThrottledMid, NumMid);
+	INC_DWORD_STAT_BY(STAT_SafeZone_NetThrottledFar, NumFar);
+}
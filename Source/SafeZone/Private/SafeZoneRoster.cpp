@@ -0,0 +1,148 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SafeZoneRoster.h"
+#include "SafeZoneGameState.h"
+
+void FSafeZoneRosterEntry::PostReplicatedAdd(const FSafeZoneRoster& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->NotifyRosterChanged();
+	}
+}
+
+void FSafeZoneRosterEntry::PostReplicatedChange(const FSafeZoneRoster& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->NotifyRosterChanged();
+	}
+}
+
+void FSafeZoneRosterEntry::PreReplicatedRemove(const FSafeZoneRoster& InArraySerializer)
+{
+	if (InArraySerializer.Owner)
+	{
+		InArraySerializer.Owner->NotifyRosterChanged();
+	}
+}
+
+void FSafeZoneRoster::AddPlayer(int32 PlayerHandle, const FString& DisplayName)
+{
+	int32 Index = FindIndex(PlayerHandle);
+	if (Index == INDEX_NONE)
+	{
+		Index = Entries.AddDefaulted();
+		Entries[Index].PlayerHandle = PlayerHandle;
+	}
+	else if (Entries[Index].bAlive)
+	{
+		return;
+	}
+
+	FSafeZoneRosterEntry& Entry = Entries[Index];
+	Entry.DisplayName = DisplayName;
+	Entry.bAlive = true;
+	Entry.bKnocked = false;
+	Entry.EliminationOrder = 0;
+	Entry.Placement = 0;
+	NumAlive++;
+
+	MarkItemDirty(Entry);
+	UpdateWinner();
+}
+
+void FSafeZoneRoster::RemovePlayer(int32 PlayerHandle)
+{
+	const int32 Index = FindIndex(PlayerHandle);
+	if (Index == INDEX_NONE)
+	{
+		return;
+	}
+
+	Eliminate(PlayerHandle);
+
+	Entries.RemoveAtSwap(Index);
+	MarkArrayDirty();
+}
+
+void FSafeZoneRoster::SetKnocked(int32 PlayerHandle, bool bKnocked)
+{
+	const int32 Index = FindIndex(PlayerHandle);
+	if (Index != INDEX_NONE && Entries[Index].bAlive && Entries[Index].bKnocked != bKnocked)
+	{
+		Entries[Index].bKnocked = bKnocked;
+		MarkItemDirty(Entries[Index]);
+	}
+}
+
+int32 FSafeZoneRoster::Eliminate(int32 PlayerHandle)
+{
+	const int32 Index = FindIndex(PlayerHandle);
+	if (Index == INDEX_NONE || !Entries[Index].bAlive)
+	{
+		return 0;
+	}
+
+	FSafeZoneRosterEntry& Entry = Entries[Index];
+	Entry.bAlive = false;
+	Entry.bKnocked = false;
+	Entry.EliminationOrder = ++NumEliminated;
+	// Everyone still standing places ahead of the player
+	Entry.Placement = NumAlive;
+	NumAlive--;
+
+	MarkItemDirty(Entry);
+	UpdateWinner();
+
+	return Entry.Placement;
+}
+
+void FSafeZoneRoster::Reset()
+{
+	Entries.Reset();
+	NumAlive = 0;
+	NumEliminated = 0;
+	MarkArrayDirty();
+}
+
+const FSafeZoneRosterEntry* FSafeZoneRoster::Find(int32 PlayerHandle) const
+{
+	const int32 Index = FindIndex(PlayerHandle);
+	return Index != INDEX_NONE ? &Entries[Index] : nullptr;
+}
+
+int32 FSafeZoneRoster::GetNumAlive() const
+{
+	int32 Count = 0;
+	for (const FSafeZoneRosterEntry& Entry : Entries)
+	{
+		Count += Entry.bAlive ? 1 : 0;
+	}
+	return Count;
+}
+
+int32 FSafeZoneRoster::FindIndex(int32 PlayerHandle) const
+{
+	return Entries.IndexOfByPredicate([PlayerHandle](const FSafeZoneRosterEntry& Entry) { return Entry.PlayerHandle == PlayerHandle; });
+}
+
+void FSafeZoneRoster::UpdateWinner()
+{
+	for (FSafeZoneRosterEntry& Entry : Entries)
+	{
+		if (!Entry.bAlive)
+		{
+			continue;
+		}
+
+		// Only a single survivor can be sure of first place, respawns take it away again
+		const int32 Placement = (NumAlive == 1 && NumEliminated > 0) ? 1 : 0;
+		if (Entry.Placement != Placement)
+		{
+			Entry.Placement = Placement;
+			MarkItemDirty(Entry);
+		}
+	}
+}
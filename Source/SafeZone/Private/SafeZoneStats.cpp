@@ -0,0 +1,24 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SafeZoneStats.h"
+
+DEFINE_STAT(STAT_SafeZone_ZoneInterpolation);
+DEFINE_STAT(STAT_SafeZone_QuadrantUpdate);
+DEFINE_STAT(STAT_SafeZone_TargetSelection);
+DEFINE_STAT(STAT_SafeZone_Membership);
+DEFINE_STAT(STAT_SafeZone_QuadrantOccupancy);
+DEFINE_STAT(STAT_SafeZone_DamagePass);
+DEFINE_STAT(STAT_SafeZone_PostGameplayEffectExecute);
+DEFINE_STAT(STAT_SafeZone_HealthChanged);
+DEFINE_STAT(STAT_SafeZone_OutsideTagChanged);
+DEFINE_STAT(STAT_SafeZone_MatchStartInit);
+
+DEFINE_STAT(STAT_SafeZone_PlayersOutside);
+DEFINE_STAT(STAT_SafeZone_PlayersInGrace);
+DEFINE_STAT(STAT_SafeZone_DamageApplicationsPerSecond);
+DEFINE_STAT(STAT_SafeZone_TransitionsPerSecond);
+DEFINE_STAT(STAT_SafeZone_NetThrottledMid);
+DEFINE_STAT(STAT_SafeZone_NetThrottledFar);
+
+CSV_DEFINE_CATEGORY_MODULE(SAFEZONE_API, SafeZone, true);
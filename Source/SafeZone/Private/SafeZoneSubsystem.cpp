@@ -0,0 +1,36 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "SafeZoneSubsystem.h"
+#include "SafeZoneActor.h"
+
+void USafeZoneSubsystem::RegisterZone(ASafeZoneActor* Zone)
+{
+	if (!Zone || Zones.Contains(Zone))
+	{
+		return;
+	}
+
+	Zones.Add(Zone);
+	OnZoneRegistered.Broadcast(Zone);
+}
+
+void USafeZoneSubsystem::UnregisterZone(ASafeZoneActor* Zone)
+{
+	if (Zones.Remove(Zone) > 0)
+	{
+		OnZoneUnregistered.Broadcast(Zone);
+	}
+}
+
+ASafeZoneActor* USafeZoneSubsystem::GetPrimarySafeZone() const
+{
+	for (ASafeZoneActor* Zone : Zones)
+	{
+		if (Zone && Zone->GetZoneKind() == ESafeZoneKind::Safe)
+		{
+			return Zone;
+		}
+	}
+	return nullptr;
+}
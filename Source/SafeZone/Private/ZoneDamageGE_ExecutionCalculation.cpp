@@ -0,0 +1,57 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ZoneDamageGE_ExecutionCalculation.h"
+#include "PlayerAttributeSet.h"
+#include "SafeZoneGameplayTags.h"
+
+// Capture definitions and the output attribute, built once and shared by every execution
+struct ZoneDamageGE_Statics
+{
+	DECLARE_ATTRIBUTE_CAPTUREDEF(DamageResistance);
+
+	FGameplayAttribute DamageAttribute;
+
+	ZoneDamageGE_Statics()
+	{
+		// Current value of the target when the effect executes
+		DEFINE_ATTRIBUTE_CAPTUREDEF(UPlayerAttributeSet, DamageResistance, Target, false);
+
+		DamageAttribute = UPlayerAttributeSet::GetDamageAttribute();
+	}
+};
+
+static const ZoneDamageGE_Statics& ZoneDamageStatics()
+{
+	static ZoneDamageGE_Statics Statics;
+	return Statics;
+}
+
+UZoneDamageGE_ExecutionCalculation::UZoneDamageGE_ExecutionCalculation()
+	: bCaptureResistance(false)
+{
+}
+
+void UZoneDamageGE_ExecutionCalculation::Execute_Implementation(const FGameplayEffectCustomExecutionParameters& ExecutionParams, OUT FGameplayEffectCustomExecutionOutput& OutExecutionOutput) const
+{
+	float Damage = FMath::Max(ExecutionParams.GetOwningSpec().GetSetByCallerMagnitude(FSafeZoneGameplayTags::Get().Data_Damage, false, 0.0f), 0.0f);
+
+	if (bCaptureResistance && Damage > 0.0f)
+	{
+		// Zone damage carries no tags a resistance modifier could depend on
+		float Resistance = 0.0f;
+		ExecutionParams.AttemptCalculateCapturedAttributeMagnitude(ZoneDamageStatics().DamageResistanceDef, FAggregatorEvaluateParameters(), Resistance);
+		Damage *= 1.0f - FMath::Clamp(Resistance, 0.0f, 1.0f);
+	}
+
+	if (Damage > 0.0f)
+	{
+		OutExecutionOutput.AddOutputModifier(FGameplayModifierEvaluatedData(ZoneDamageStatics().DamageAttribute, EGameplayModOp::Additive, Damage));
+	}
+}
+
+UZoneDamageResistGE_ExecutionCalculation::UZoneDamageResistGE_ExecutionCalculation()
+{
+	bCaptureResistance = true;
+	RelevantAttributesToCapture.Add(ZoneDamageStatics().DamageResistanceDef);
+}
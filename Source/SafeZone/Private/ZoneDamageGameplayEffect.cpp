@@ -0,0 +1,14 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+
+#include "ZoneDamageGameplayEffect.h"
+#include "ZoneDamageGE_ExecutionCalculation.h"
+
+UZoneDamageGameplayEffect::UZoneDamageGameplayEffect()
+{
+	DurationPolicy = EGameplayEffectDurationType::Instant;
+
+	FGameplayEffectExecutionDefinition Execution;
+	Execution.CalculationClass = UZoneDamageGE_ExecutionCalculation::StaticClass();
+	Executions.Add(Execution);
+}
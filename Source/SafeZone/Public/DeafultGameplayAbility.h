@@ -8,7 +8,10 @@
 #include "DeafultGameplayAbility.generated.h"
 
 /**
- * 
+ * Base ability of the game, instanced once per character it is granted to. The instance lives as long as
+ * the ability is granted, so its members keep their values between activations. Abilities that don't need
+ * that derive from UDeafultGameplayAbility_NonInstanced or UDeafultGameplayAbility_InstancedPerExecution
+ * instead, SafeZone.Bench.AbilityInstances lists the instances each character holds.
  */
 UCLASS()
 class SAFEZONE_API UDeafultGameplayAbility : public UGameplayAbility
@@ -18,6 +21,8 @@ class SAFEZONE_API UDeafultGameplayAbility : public UGameplayAbility
 	public:
 	UDeafultGameplayAbility();
 
+	virtual void PostInitProperties() override;
+
 	// Tells an ability to activate immediately when its granted. Used for passive abilities and abilites forced on others.
 	UPROPERTY(BlueprintReadWrite, EditAnywhere, Category = "Ability")
 	bool bActivateAbilityOnGranted;
@@ -25,3 +30,32 @@ class SAFEZONE_API UDeafultGameplayAbility : public UGameplayAbility
 private:
 	bool bActivateOnInput;
 };
+
+/**
+ * Ability without any instance, every activation of every character runs on the class default object.
+ * For passive and stateless abilities. Members must not be written after construction: anything that
+ * differs per character or activation is read from the handle, the actor info and the activation info.
+ * Ability tasks, latent nodes, timers and replicated members can't be used.
+ */
+UCLASS(Abstract)
+class SAFEZONE_API UDeafultGameplayAbility_NonInstanced : public UDeafultGameplayAbility
+{
+	GENERATED_BODY()
+
+	public:
+	UDeafultGameplayAbility_NonInstanced();
+};
+
+/**
+ * Ability instanced on every activation, the instance is released when the activation ends. Members are
+ * only valid for one activation and start from the class defaults on the next, nothing is kept on the
+ * character while the ability is inactive. Ability tasks can be used, but the instance doesn't replicate.
+ */
+UCLASS(Abstract)
+class SAFEZONE_API UDeafultGameplayAbility_InstancedPerExecution : public UDeafultGameplayAbility
+{
+	GENERATED_BODY()
+
+	public:
+	UDeafultGameplayAbility_InstancedPerExecution();
+};
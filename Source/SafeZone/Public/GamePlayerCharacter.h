@@ -1,155 +1,207 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "GameFramework/Character.h"
-#include "AbilitySystemComponent.h"
-#include "AbilitySystemInterface.h"
-#include "GamePlayerCharacter.generated.h"
-
-
-
-
-UCLASS()
-class SAFEZONE_API AGamePlayerCharacter : public ACharacter , public IAbilitySystemInterface
-{
-	GENERATED_BODY()
-public:
-
-	AGamePlayerCharacter();
-
-	/** Base turn rate, in deg/sec. Other scaling may affect final turn rate. */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category=Camera)
-	float BaseTurnRate;
-
-	/** Base look up/down rate, in deg/sec. Other scaling may affect final rate. */
-	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category=Camera)
-	float BaseLookUpRate;
-
-    // Ability System Interface
-    UFUNCTION(BlueprintCallable, Category = "Abilities")
-    virtual UAbilitySystemComponent* GetAbilitySystemComponent() const override;
-
-	UFUNCTION(BlueprintCallable, Category = "Character|State")
-	bool IsCharacterAlive();
-
-	// Removes all CharacterAbilities. Can only be called by the Server. Removing on the Server will remove from Client too.
-	virtual void RemoveCharacterAbilities();
-
-	virtual void Die();
-
-	UFUNCTION(BlueprintCallable, Category = "Character|State")
-	virtual void FinishDying();
-
-	UFUNCTION(BlueprintCallable, Category = "Character|Attributes")
-	float GetCharacterHealth() const;
-
-	UFUNCTION(BlueprintCallable, Category = "Character|Attributes")
-	float GetCharacterMaxHealth() const;
-
-	// RPC to play knockdown montage on all clients
-    UFUNCTION(NetMulticast, Reliable)
-    void MulticastPlayKnockdownAnimation();
-
-    // RPC to play death montage on all clients
-    UFUNCTION(NetMulticast, Reliable)
-    void MulticastPlayDeathAnimation();
-
-	void ApplyOutsideSafeZoneTag();
-
-	void RemoveOutsideSafeZoneTag();
-
-	UPROPERTY(Replicated, BlueprintReadOnly, Category = "Anim State")
-	bool IsCharacterDead;
-
-protected:
-
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Abilities")
-    UAbilitySystemComponent* AbilitySystemComponent;
-
-protected:
-
-	// Reference to the AttributeSetBase. It will live on the PlayerState or here if the character doesn't have a PlayerState.
-	UPROPERTY()
-	class UPlayerAttributeSet* PlayerAttribute;
-
-	//trigger a montage of death
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Character|Animation")
-	UAnimMontage* DeathMontage;
-
-	// Default abilities for this Character. These will be removed on Character death and regiven if Character respawns.
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Character|Abilities")
-	TArray<TSubclassOf<class UGameplayAbility>> CharacterAbilities;
-
-	// Default attributes for a character for initializing on spawn/respawn.
-	// This is an instant GE that overrides the values for attributes that get reset on spawn/respawn.
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Character|Abilities")
-	TSubclassOf<class UGameplayEffect> DefaultAttributes;
-
-	// These effects are only applied one time on startup
-	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Character|Abilities")
-	TArray<TSubclassOf<class UGameplayEffect>> StartupEffects;
-
-	UPROPERTY(BlueprintReadOnly,EditAnywhere, Category = "Character | Effects")
-	TSubclassOf<class UGameplayEffect> DamageEffectClass;
-
-	// Grant abilities on the Server. The Ability Specs will be replicated to the owning client.
-	virtual void AddCharacterAbilities();
-
-	// Initialize the Character's attributes. Must run on Server but we run it on Client too
-	// so that we don't have to wait. The Server's replication to the Client won't matter since
-	// the values should be the same.
-	virtual void InitializeAttributes();
-
-	virtual void AddStartupEffects();
-
-	virtual void BeginPlay() override;
-
-	void HealthChanged(const FOnAttributeChangeData& Data);
-
-	void OutsideSafeZoneTagChanged(const FGameplayTag CallbackTag, int32 NewCount);
-
-	void Knockdown();
-
-	virtual void PossessedBy(AController* NewController) override;
-
-	// Replicate properties
-	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
-	/**
-* Setters for Attributes. Only use these in special cases like Respawning, otherwise use a GE to change Attributes.
-* These change the Attribute's Base Value.
-*/
-
-	virtual void SetHealth(float Health);
-
-private:
-
-	UPROPERTY(ReplicatedUsing=OnRep_IsKnockedDown)
-	bool bIsKnockedDown;
-
-	// Called when the bIsKnockedDown property is replicated
-    UFUNCTION()
-    void OnRep_IsKnockedDown();
-
-	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Health", meta = (AllowPrivateAccess = "true"))
-	float KnockdownHealthThreshold;
-
-	bool bCharacterAbilitiesGiven;
-
-	bool bStartupEffectsApplied;
-
-	FGameplayTag OutsideSafeZoneTag;
-
-	FTimerHandle DamageTimerHandle;
-
-	FActiveGameplayEffectHandle DamageEffectHandle;
-
-	float DamageInterval = 1; // will be set by the current iteration
-
-//Networking
-public:
-
-	FString GetPlayerUniqueNetIdAsString();
-
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Character.h"
+#include "AbilitySystemComponent.h"
+#include "AbilitySystemInterface.h"
+#include "GamePlayerCharacter.generated.h"
+
+
+
+
+UCLASS()
+class SAFEZONE_API AGamePlayerCharacter : public ACharacter , public IAbilitySystemInterface
+{
+	GENERATED_BODY()
+public:
+
+	AGamePlayerCharacter();
+
+	/** Base turn rate, in deg/sec. Other scaling may affect final turn rate. */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category=Camera)
+	float BaseTurnRate;
+
+	/** Base look up/down rate, in deg/sec. Other scaling may affect final rate. */
+	UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category=Camera)
+	float BaseLookUpRate;
+
+    // Ability System Interface
+    UFUNCTION(BlueprintCallable, Category = "Abilities")
+    virtual UAbilitySystemComponent* GetAbilitySystemComponent() const override;
+
+	UFUNCTION(BlueprintCallable, Category = "Character|State")
+	bool IsCharacterAlive();
+
+	// Removes all CharacterAbilities. Can only be called by the Server. Removing on the Server will remove from Client too.
+	virtual void RemoveCharacterAbilities();
+
+	virtual void Die();
+
+	UFUNCTION(BlueprintCallable, Category = "Character|State")
+	virtual void FinishDying();
+
+	// Simulated proxies only receive a quantized health, see ProxyHealth
+	UFUNCTION(BlueprintCallable, Category = "Character|Attributes")
+	float GetCharacterHealth() const;
+
+	UFUNCTION(BlueprintCallable, Category = "Character|Attributes")
+	float GetCharacterMaxHealth() const;
+
+	void ApplyOutsideSafeZoneTag();
+
+	void RemoveOutsideSafeZoneTag();
+
+	// Handle of the owning player in the game mode player registry, INDEX_NONE when not registered.
+	// Replicated, clients use it as the slot of the player in the ASafeZoneGameState bit arrays
+	int32 GetPlayerHandle() const { return PlayerHandle; }
+
+	void SetPlayerHandle(int32 Handle);
+
+	TSubclassOf<class UGameplayEffect> GetDamageEffectClass() const { return DamageEffectClass; }
+
+	// Attributes, startup effects, abilities and registry binding of a possessed character. Run from PossessedBy,
+	// or later by the game mode match start pipeline. Server only
+	void InitializeForPlay();
+
+	// Hides the unpossessed character and takes it out of play so the game mode can pool it. Server only
+	void DeactivateForPool();
+
+	// Brings a pooled character back alive at the transform, the next possession takes the fast respawn path. Server only
+	void ActivateFromPool(const FTransform& SpawnTransform);
+
+	UPROPERTY(ReplicatedUsing = OnRep_IsCharacterDead, BlueprintReadOnly, Category = "Anim State")
+	bool IsCharacterDead;
+
+	// Server world time of the death and of the last knockdown, so late joiners only see the end of the montages
+	UPROPERTY(Replicated, BlueprintReadOnly, Category = "Anim State")
+	float DeathTime;
+
+	UPROPERTY(Replicated, BlueprintReadOnly, Category = "Anim State")
+	float KnockdownTime;
+
+protected:
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Abilities")
+    UAbilitySystemComponent* AbilitySystemComponent;
+
+protected:
+
+	// Reference to the AttributeSetBase. It will live on the PlayerState or here if the character doesn't have a PlayerState.
+	UPROPERTY()
+	class UPlayerAttributeSet* PlayerAttribute;
+
+	//trigger a montage of death
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Character|Animation")
+	UAnimMontage* DeathMontage;
+
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Character|Animation")
+	UAnimMontage* KnockdownMontage;
+
+	// Default abilities for this Character. These will be removed on Character death and regiven if Character respawns.
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Character|Abilities")
+	TArray<TSubclassOf<class UGameplayAbility>> CharacterAbilities;
+
+	// Default attributes for a character for initializing on spawn/respawn.
+	// This is an instant GE that overrides the values for attributes that get reset on spawn/respawn.
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Character|Abilities")
+	TSubclassOf<class UGameplayEffect> DefaultAttributes;
+
+	// These effects are only applied one time on startup
+	UPROPERTY(BlueprintReadOnly, EditAnywhere, Category = "Character|Abilities")
+	TArray<TSubclassOf<class UGameplayEffect>> StartupEffects;
+
+	UPROPERTY(BlueprintReadOnly,EditAnywhere, Category = "Character | Effects")
+	TSubclassOf<class UGameplayEffect> DamageEffectClass;
+
+	// Grant abilities on the Server. The Ability Specs will be replicated to the owning client.
+	virtual void AddCharacterAbilities();
+
+	// Initialize the Character's attributes. Must run on Server but we run it on Client too
+	// so that we don't have to wait. The Server's replication to the Client won't matter since
+	// the values should be the same.
+	virtual void InitializeAttributes();
+
+	virtual void AddStartupEffects();
+
+	virtual void PostInitProperties() override;
+
+	virtual void BeginPlay() override;
+
+	void HealthChanged(const FOnAttributeChangeData& Data);
+
+	void OutsideSafeZoneTagChanged(const FGameplayTag CallbackTag, int32 NewCount);
+
+	void Knockdown();
+
+	virtual void PossessedBy(AController* NewController) override;
+
+	// Replicate properties
+	virtual void GetLifetimeReplicatedProps(TArray<FLifetimeProperty>& OutLifetimeProps) const override;
+	/**
+* Setters for Attributes. Only use these in special cases like Respawning, otherwise use a GE to change Attributes.
+* These change the Attribute's Base Value.
+*/
+
+	virtual void SetHealth(float Health);
+
+private:
+
+	UPROPERTY(ReplicatedUsing=OnRep_IsKnockedDown)
+	bool bIsKnockedDown;
+
+	// Called when the bIsKnockedDown property is replicated
+    UFUNCTION()
+    void OnRep_IsKnockedDown();
+
+	UFUNCTION()
+	void OnRep_IsCharacterDead();
+
+	// Plays the montage from where it would be now given the server time its state started at
+	void PlayStateMontage(UAnimMontage* Montage, float StateStartTime);
+
+	float GetServerWorldTime() const;
+
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Health", meta = (AllowPrivateAccess = "true"))
+	float KnockdownHealthThreshold;
+
+	bool bCharacterAbilitiesGiven;
+
+	bool bStartupEffectsApplied;
+
+	FGameplayTag OutsideSafeZoneTag;
+
+	UPROPERTY(Replicated)
+	int32 PlayerHandle;
+
+	// Health as a fraction of max health in ProxyHealthSteps steps, for the connections that don't own the
+	// character. The Health attribute itself only replicates to the owner.
+	UPROPERTY(Replicated)
+	uint8 ProxyHealth;
+
+	// Resolution of ProxyHealth, between 1 and 255. A change smaller than a step isn't sent to the proxies
+	UPROPERTY(EditDefaultsOnly, Category = "Health", meta = (ClampMin = "1", ClampMax = "255"))
+	uint8 ProxyHealthSteps;
+
+	void UpdateProxyHealth(float Health);
+
+	FTimerHandle FinishDyingTimerHandle;
+
+	// Attribute base values right after the first full initialization, restored in place on pooled respawns
+	TArray<FGameplayAttribute> SpawnAttributes;
+
+	TArray<float> SpawnAttributeValues;
+
+	void CaptureSpawnAttributes();
+
+	void RestoreSpawnAttributes();
+
+	class ASafeZoneGameMode* GetSafeZoneGameMode() const;
+
+//Networking
+public:
+
+	FString GetPlayerUniqueNetIdAsString();
+
+};
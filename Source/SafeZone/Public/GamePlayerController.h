@@ -1,22 +1,62 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "GameFramework/PlayerController.h"
-#include "GamePlayerController.generated.h"
-
-/**
- * 
- */
-UCLASS()
-class SAFEZONE_API AGamePlayerController : public APlayerController
-{
-	GENERATED_BODY()
-
-public:
-
-	UFUNCTION(BlueprintImplementableEvent,Category = "Final Death Widget")
-	void EndGameReturnToMain();
-	
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/PlayerController.h"
+#include "GameplayTagContainer.h"
+#include "SafeZoneFrameBatchQueue.h"
+#include "GamePlayerController.generated.h"
+
+// A gameplay cue executed locally on the owning client only, see AGamePlayerController::QueueLocalGameplayCue
+USTRUCT()
+struct FSafeZoneLocalGameplayCue
+{
+	GENERATED_BODY()
+
+	UPROPERTY()
+	FGameplayTag CueTag;
+
+	// Passed to the cue as its raw magnitude, the damage for zone damage cues
+	UPROPERTY()
+	float Magnitude;
+
+	FSafeZoneLocalGameplayCue()
+		: Magnitude(0.0f)
+	{
+	}
+};
+
+/**
+ * 
+ */
+UCLASS()
+class SAFEZONE_API AGamePlayerController : public APlayerController
+{
+	GENERATED_BODY()
+
+public:
+	AGamePlayerController();
+
+	UFUNCTION(BlueprintImplementableEvent,Category = "Final Death Widget")
+	void EndGameReturnToMain();
+
+	// Server only. Cues queued during a frame go out together in one unreliable client RPC after the actors ticked,
+	// and are executed on the pawn of the owning client only. Dropped batches are not resent
+	void QueueLocalGameplayCue(const FGameplayTag& CueTag, float Magnitude = 0.0f);
+
+protected:
+	virtual void BeginPlay() override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	UFUNCTION(Client, Unreliable)
+	void ClientExecuteLocalGameplayCues(const TArray<FSafeZoneLocalGameplayCue>& Cues);
+
+	// Upper bound of cues per client RPC
+	UPROPERTY(EditDefaultsOnly, Category = "Gameplay Cues")
+	int32 MaxLocalGameplayCuesPerBatch;
+
+private:
+	TSafeZoneFrameBatchQueue<FSafeZoneLocalGameplayCue> PendingLocalGameplayCues;
+};
@@ -38,6 +38,12 @@ public:
 	UPROPERTY(BlueprintReadOnly, Category = "Damage")
 	FGameplayAttributeData Damage;
 	ATTRIBUTE_ACCESSORS(UPlayerAttributeSet, Damage)
+
+	// Fraction of zone and environmental damage prevented, 0 to 1. Read by UZoneDamageResistGE_ExecutionCalculation
+	// on the server. Not replicated.
+	UPROPERTY(BlueprintReadOnly, Category = "Damage")
+	FGameplayAttributeData DamageResistance;
+	ATTRIBUTE_ACCESSORS(UPlayerAttributeSet, DamageResistance)
     
     virtual void PreAttributeChange(const FGameplayAttribute& Attribute, float& NewValue) override;
     virtual void PostGameplayEffectExecute(const FGameplayEffectModCallbackData& Data) override;
@@ -53,6 +59,10 @@ protected:
     UFUNCTION()
 	virtual void OnRep_MaxHealth(const FGameplayAttributeData& OldMaxHealth);
 
+    // Instigator avatar of the effect, or the effect causer when set, with its controller. Null for damage
+    // without instigator and for self inflicted damage
+    static AActor* ResolveSource(const FGameplayEffectModCallbackData& Data, AController*& OutSourceController);
+
     // Helper function to proportionally adjust the value of an attribute when it's associated max attribute changes.
     // (i.e. When MaxHealth increases, Health increases by an amount that maintains the same percentage as before)
     void AdjustAttributeForMaxChange(FGameplayAttributeData& AffectedAttribute, const FGameplayAttributeData& MaxAttribute, float NewMaxValue, const FGameplayAttribute& AffectedAttributeProperty);
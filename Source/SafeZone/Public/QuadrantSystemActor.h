@@ -1,40 +1,77 @@
-#pragma once
-#include "CoreMinimal.h"
-#include "GameFramework/Actor.h"
-#include "Components/SphereComponent.h"
-#include "QuadrantSystemActor.generated.h"
-
-
-class AGamePlayerCharacter;
-
-UCLASS()
-class SAFEZONE_API AQuadrantSystemActor : public AActor
-{
-    GENERATED_BODY()
-
-public:    
-    AQuadrantSystemActor();
-
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Quadrant")
-    USphereComponent* QuadrantSphere;
-
-    TArray<AGamePlayerCharacter*> GetPlayersInQuadrant() const;
-    int32 GetNumberOfPlayersInQuadrant() const;
-
-    FVector GetRandomLocationInQuadrant() const;
-
-    bool IsPlayerInside(const FString& PlayerID) const;
-
-protected:
-    virtual void BeginPlay() override;
-
-private:
-    TArray<AGamePlayerCharacter*> PlayersInQuadrant;
-
-    UFUNCTION()
-    void OnPlayerEnterQuadrant(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex, bool bFromSweep, const FHitResult& SweepResult);
-
-    UFUNCTION()
-    void OnPlayerExitQuadrant(UPrimitiveComponent* OverlappedComponent, AActor* OtherActor, UPrimitiveComponent* OtherComp, int32 OtherBodyIndex);
-   
-};
+#pragma once
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Components/SphereComponent.h"
+#include "QuadrantSystemActor.generated.h"
+
+
+class AGamePlayerCharacter;
+class ASafeZoneActor;
+class FSafeZonePlayerRegistry;
+
+// Logical quadrant of the safe zone. Plain server side data owned by ASafeZoneActor,
+// occupancy is filled by the game mode membership pass. Only player handles are kept,
+// characters are resolved through the player registry when asked for.
+struct SAFEZONE_API FSafeZoneQuadrant
+{
+    FVector Center;
+
+    float Radius;
+
+    FSafeZoneQuadrant()
+        : Center(ForceInitToZero)
+        , Radius(0.0f)
+    {
+    }
+
+    // Characters of the players still registered, players that left since the last pass are skipped
+    TArray<AGamePlayerCharacter*> GetPlayersInQuadrant(const FSafeZonePlayerRegistry& PlayerRegistry) const;
+    int32 GetNumberOfPlayersInQuadrant() const;
+
+    FVector GetRandomLocationInQuadrant() const;
+
+    // PlayerHandle is a handle of the game mode player registry
+    bool IsPlayerInside(int32 PlayerHandle) const;
+
+    void ResetPlayersInQuadrant();
+
+    void AddPlayerToQuadrant(int32 PlayerHandle);
+
+private:
+    TArray<int32> PlayerHandlesInQuadrant;
+};
+
+// Optional debug visualization of a quadrant. Not replicated and without collision, it only
+// mirrors the quadrant data of its safe zone.
+UCLASS()
+class SAFEZONE_API AQuadrantSystemActor : public AActor
+{
+    GENERATED_BODY()
+
+public:
+    AQuadrantSystemActor();
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Quadrant")
+    USphereComponent* QuadrantSphere;
+
+    void SetQuadrant(ASafeZoneActor* InSafeZone, int32 InQuadrantIndex);
+
+    // Server only, resolved through the player registry of the game mode
+    TArray<AGamePlayerCharacter*> GetPlayersInQuadrant() const;
+    int32 GetNumberOfPlayersInQuadrant() const;
+
+    FVector GetRandomLocationInQuadrant() const;
+
+    bool IsPlayerInside(int32 PlayerHandle) const;
+
+protected:
+    virtual void BeginPlay() override;
+
+private:
+    const FSafeZoneQuadrant* GetQuadrant() const;
+
+    UPROPERTY()
+    ASafeZoneActor* SafeZone;
+
+    int32 QuadrantIndex;
+};
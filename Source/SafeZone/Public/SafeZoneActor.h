@@ -1,83 +1,266 @@
-#pragma once
-
-#include "CoreMinimal.h"
-#include "GameFramework/Actor.h"
-#include "Components/SphereComponent.h"
-#include "Components/StaticMeshComponent.h"
-#include "QuadrantSystemActor.h"
-#include "SafeZoneActor.generated.h"
-
-UCLASS()
-class SAFEZONE_API ASafeZoneActor : public AActor
-{
-    GENERATED_BODY()
-
-public:    
-    ASafeZoneActor();
-
-protected:
-    virtual void BeginPlay() override;
-    virtual void Tick(float DeltaTime) override;
-
-    UPROPERTY(ReplicatedUsing = OnRep_UpdateSafeZone)
-    FVector TargetLocation;
-
-    UPROPERTY(ReplicatedUsing = OnRep_UpdateSafeZone)
-    float TargetRadius;
-
-    UPROPERTY(Replicated)
-    bool bShouldShrink;
-
-    UFUNCTION()
-    void OnRep_UpdateSafeZone();
-
-    virtual void GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const override;
-
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Safe Zone")
-    USphereComponent* SafeZoneSphere;
-
-    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Safe Zone | Visualization")
-    UStaticMeshComponent* SafeZoneVisual;
-
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Safe Zone")
-    float ShrinkSpeed;
-
-    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Safe Zone")
-    int32 MaxIterations;
-
-    int32 GetCurrentIteration()
-    {
-        return CurrentIteration;
-    }
-
-private:
-    TArray<AQuadrantSystemActor*> Quadrants;
-
-    int32 CurrentIteration;
-
-    int8 MinSafeZoneRadius;
-
-    void CreateQuadrants();
-
-    void UpdateQuadrants(float NewRadius, FVector NewCenter);
-
-    void ShrinkSafeZone();
-
-    void MoveSafeZone(FVector NewLocation);
-
-    void UpdateSafeZoneProperties();
-
-    AQuadrantSystemActor* FindQuadrantWithMinimumPlayers();
-
-    // Timer handle for delaying the shrinking process
-    FTimerHandle ShrinkDelayTimerHandle;
-
-    // Function to start the shrinking process after a delay
-    void StartShrinkingWithDelay(float DelayInSeconds);
-
-public:
-    TArray<AQuadrantSystemActor*> GetQuadrantsInSafeZone()
-    {
-        return Quadrants;
-    }
-};
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "Components/SphereComponent.h"
+#include "Components/StaticMeshComponent.h"
+#include "QuadrantSystemActor.h"
+#include "SafeZonePlayerGrid.h"
+#include "SafeZoneActor.generated.h"
+
+// One shrink phase of the safe zone. The server publishes it once when the phase starts and
+// everyone evaluates the zone from it using the synchronized server world time.
+// Centers and radii go over the wire as integers in steps of Precision, see NetSerialize.
+USTRUCT()
+struct SAFEZONE_API FSafeZonePhase
+{
+    GENERATED_BODY()
+
+    // 0 for the resting zone published at begin play, then the number of the running shrink phase
+    UPROPERTY()
+    uint8 PhaseIndex;
+
+    // Server world time the phase starts at. Negative until the server has published a phase.
+    UPROPERTY()
+    float StartTime;
+
+    UPROPERTY()
+    float Duration;
+
+    UPROPERTY()
+    FVector StartCenter;
+
+    UPROPERTY()
+    FVector EndCenter;
+
+    UPROPERTY()
+    float StartRadius;
+
+    UPROPERTY()
+    float EndRadius;
+
+    // Quantization step of centers and radii in world units, sent along with the phase
+    UPROPERTY()
+    float Precision;
+
+    FSafeZonePhase()
+        : PhaseIndex(0)
+        , StartTime(-1.0f)
+        , Duration(0.0f)
+        , StartCenter(ForceInitToZero)
+        , EndCenter(ForceInitToZero)
+        , StartRadius(0.0f)
+        , EndRadius(0.0f)
+        , Precision(1.0f)
+    {
+    }
+
+    bool IsValid() const
+    {
+        return StartTime >= 0.0f;
+    }
+
+    float GetEndTime() const
+    {
+        return StartTime + Duration;
+    }
+
+    // Center and radius of the zone at the given server world time
+    void Evaluate(float ServerTime, FVector& OutCenter, float& OutRadius) const;
+
+    // Snaps centers and radii to the Precision grid, so the server evaluates exactly what clients receive
+    void Quantize();
+
+    bool NetSerialize(FArchive& Ar, class UPackageMap* Map, bool& bOutSuccess);
+
+    bool operator==(const FSafeZonePhase& Other) const
+    {
+        return PhaseIndex == Other.PhaseIndex
+            && StartTime == Other.StartTime
+            && Duration == Other.Duration
+            && StartCenter == Other.StartCenter
+            && EndCenter == Other.EndCenter
+            && StartRadius == Other.StartRadius
+            && EndRadius == Other.EndRadius
+            && Precision == Other.Precision;
+    }
+};
+
+template<>
+struct TStructOpsTypeTraits<FSafeZonePhase> : public TStructOpsTypeTraitsBase2<FSafeZonePhase>
+{
+    enum
+    {
+        WithNetSerializer = true,
+        WithIdenticalViaEquality = true,
+    };
+};
+
+// How the membership pass treats a zone. A player is inside when within any safe zone (or there is
+// no safe zone at all) and not within any hazard zone.
+UENUM(BlueprintType)
+enum class ESafeZoneKind : uint8
+{
+    Safe,
+    Hazard
+};
+
+UCLASS()
+class SAFEZONE_API ASafeZoneActor : public AActor
+{
+    GENERATED_BODY()
+
+public:
+    ASafeZoneActor();
+
+protected:
+    virtual void BeginPlay() override;
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+    virtual void Tick(float DeltaTime) override;
+
+    // Replicated once per phase through the push model, clients interpolate locally from it
+    UPROPERTY(ReplicatedUsing = OnRep_ShrinkPhase)
+    FSafeZonePhase ShrinkPhase;
+
+    UFUNCTION()
+    void OnRep_ShrinkPhase();
+
+    virtual void GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const override;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Safe Zone")
+    USphereComponent* SafeZoneSphere;
+
+    UPROPERTY(VisibleAnywhere, BlueprintReadOnly, Category = "Safe Zone | Visualization")
+    UStaticMeshComponent* SafeZoneVisual;
+
+    // Safe zones keep players in, hazard zones keep them out
+    UPROPERTY(EditAnywhere, BlueprintReadOnly, Category = "Safe Zone")
+    ESafeZoneKind ZoneKind;
+
+    // Time in seconds the zone takes to move and shrink to its next target
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Safe Zone")
+    float ShrinkDuration;
+
+    // Time in seconds the zone rests before the next shrink phase starts
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Safe Zone")
+    float ShrinkDelay;
+
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Safe Zone")
+    int32 MaxIterations;
+
+    // Spawns a local, non-replicated sphere per quadrant so they can be seen while debugging
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Safe Zone | Visualization")
+    bool bShowQuadrantDebugActors;
+
+    // Cell size of the player density grid used to pick the next zone target
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Safe Zone")
+    float PlayerGridCellSize;
+
+    // Quantization step in world units of the replicated zone center and radius
+    UPROPERTY(EditAnywhere, BlueprintReadWrite, Category = "Safe Zone", meta = (ClampMin = "0.01"))
+    float NetQuantizePrecision;
+
+private:
+    TArray<FSafeZoneQuadrant> Quadrants;
+
+    UPROPERTY()
+    TArray<AQuadrantSystemActor*> QuadrantDebugActors;
+
+    int32 CurrentIteration;
+
+    bool bZoneActivated;
+
+    // Zone published at begin play, restored by ResetZone
+    FVector InitialCenter;
+
+    float InitialRadius;
+
+    int8 MinSafeZoneRadius;
+
+    void CreateQuadrants();
+
+    void UpdateQuadrants(float NewRadius, FVector NewCenter);
+
+    void ShrinkSafeZone();
+
+    void FinishShrinkPhase();
+
+    void UpdateSafeZoneProperties(float ServerTime);
+
+    // Quantizes the shrink phase and marks it dirty for replication, the only place it gets sent from
+    void PublishShrinkPhase();
+
+    float GetServerWorldTime() const;
+
+    // Server only, player positions are pushed in by the game mode membership pass
+    FSafeZonePlayerGrid PlayerGrid;
+
+    // Grid item of every tracked player, indexed by registry handle, INDEX_NONE when not tracked
+    TArray<int32> PlayerGridItems;
+
+    // Timer handle for delaying the shrinking process
+    FTimerHandle ShrinkDelayTimerHandle;
+
+    // Timer handle for the end of the running shrink phase
+    FTimerHandle ShrinkPhaseTimerHandle;
+
+    // Function to start the shrinking process after a delay
+    void StartShrinkingWithDelay(float DelayInSeconds);
+
+public:
+    // Starts the shrink schedule, the game mode calls it once the match start initialization is done. Server only
+    void ActivateZone();
+
+    // Back to the initial zone and iteration with the shrink schedule stopped, for a match reset. Server only
+    void ResetZone();
+
+    ESafeZoneKind GetZoneKind() const
+    {
+        return ZoneKind;
+    }
+
+    // Adds the player to the density grid or moves it there. Server only
+    void TrackPlayer(int32 PlayerHandle, const FVector& Position);
+
+    void UntrackPlayer(int32 PlayerHandle);
+
+    bool IsZoneActivated() const
+    {
+        return bZoneActivated;
+    }
+
+    int32 GetCurrentIteration() const
+    {
+        return CurrentIteration;
+    }
+
+    // Index of the replicated shrink phase, also valid on clients
+    int32 GetPhaseIndex() const
+    {
+        return ShrinkPhase.PhaseIndex;
+    }
+
+    // True once the last shrink phase has been applied
+    bool HasFinishedShrinking() const
+    {
+        return CurrentIteration >= MaxIterations;
+    }
+
+    // Center and radius of the zone right now, evaluated from the replicated shrink phase
+    void GetCurrentZone(FVector& OutCenter, float& OutRadius) const;
+
+    FSafeZonePlayerGrid& GetPlayerGrid()
+    {
+        return PlayerGrid;
+    }
+
+    const TArray<FSafeZoneQuadrant>& GetQuadrantsInSafeZone() const
+    {
+        return Quadrants;
+    }
+
+    TArray<FSafeZoneQuadrant>& GetQuadrantsInSafeZone()
+    {
+        return Quadrants;
+    }
+};
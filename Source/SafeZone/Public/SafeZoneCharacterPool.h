@@ -0,0 +1,37 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AGamePlayerCharacter;
+class UWorld;
+
+/**
+ * Dead characters waiting to be reused instead of destroyed. Owned by the game mode and only used on the server.
+ * Pooled characters stay in the world hidden, without collision and dormant, and keep their ability system
+ * setup so a respawn only has to reset them in place, see AGamePlayerCharacter::ActivateFromPool.
+ */
+class SAFEZONE_API FSafeZoneCharacterPool
+{
+public:
+	// Takes a pooled character of exactly the given class and activates it at the transform, nullptr if none is free
+	AGamePlayerCharacter* Acquire(TSubclassOf<AGamePlayerCharacter> CharacterClass, const FTransform& SpawnTransform);
+
+	// Deactivates the character and keeps it for a later Acquire. The character must already be unpossessed
+	void Release(AGamePlayerCharacter* PlayerCharacter);
+
+	// Spawns and pools characters up front, so the first respawns don't pay for construction either
+	void Prewarm(UWorld* World, TSubclassOf<AGamePlayerCharacter> CharacterClass, int32 Count);
+
+	// Destroys every pooled character
+	void Reset();
+
+	int32 GetNumAvailable() const
+	{
+		return Available.Num();
+	}
+
+private:
+	TArray<TWeakObjectPtr<AGamePlayerCharacter>> Available;
+};
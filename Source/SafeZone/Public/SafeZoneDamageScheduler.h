@@ -0,0 +1,128 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayEffect.h"
+
+class AGamePlayerCharacter;
+
+/**
+ * Applies out of zone damage to every registered player in one pass per fixed step, through the effect
+ * set with SetEffectClass.
+ * Owned by the game mode and only used on the server. If a frame is longer than a step the missed
+ * steps are run back to back, so the damage a player takes only depends on the time spent outside.
+ *
+ * Every damage level has its own spec, built once and never changed, so a pass doesn't build any spec
+ * or context. The default path is not allocation free: the ability system component copies the spec on
+ * every application. Only SetApplyDirectly avoids heap allocations, it lowers the health on the attribute
+ * set and skips the gameplay effect with its execution, cues and callbacks.
+ */
+class SAFEZONE_API FSafeZoneDamageScheduler
+{
+public:
+	FSafeZoneDamageScheduler();
+
+	void SetStepInterval(float InStepInterval);
+
+	float GetStepInterval() const
+	{
+		return StepInterval;
+	}
+
+	// Upper bound of passes run in one frame, steps beyond it are carried over to the next frames
+	void SetMaxStepsPerFrame(int32 InMaxStepsPerFrame);
+
+	// Skips the gameplay effect and sets the health base value, so no execution, cue or effect callback runs for zone damage
+	void SetApplyDirectly(bool bInApplyDirectly)
+	{
+		bApplyDirectly = bInApplyDirectly;
+	}
+
+	bool IsApplyingDirectly() const
+	{
+		return bApplyDirectly;
+	}
+
+	// Effect applied to the players, its executions must not capture source attributes, see SharedContext
+	void SetEffectClass(TSubclassOf<UGameplayEffect> InEffectClass)
+	{
+		EffectClass = InEffectClass;
+	}
+
+	TSubclassOf<UGameplayEffect> GetEffectClass() const
+	{
+		return EffectClass;
+	}
+
+	// Builds the specs of the damage levels ahead of the passes that use them
+	void PrebuildSpecs(TSubclassOf<UGameplayEffect> SpecEffectClass, const TArray<float>& Damages);
+
+	void AddPlayer(AGamePlayerCharacter* PlayerCharacter);
+
+	void RemovePlayer(AGamePlayerCharacter* PlayerCharacter);
+
+	int32 GetNumPlayers() const
+	{
+		return Players.Num();
+	}
+
+	// Advances the scheduler clock and runs one pass per elapsed step with the given damage, returns the number of effects applied
+	int32 Advance(float DeltaSeconds, float DamagePerStep);
+
+	// Drops all players, the clock and the cached specs
+	void Reset();
+
+	double GetLastPassSeconds() const
+	{
+		return LastPassSeconds;
+	}
+
+	double GetAveragePassSeconds() const
+	{
+		return AveragePassSeconds;
+	}
+
+	int32 GetLastPassApplications() const
+	{
+		return LastPassApplications;
+	}
+
+private:
+	void RunPass(float Damage);
+
+	// Index into CachedSpecs, INDEX_NONE without effect class. Pointers into the array don't survive the next add
+	int32 FindOrCreateSpec(TSubclassOf<UGameplayEffect> SpecEffectClass, float Damage);
+
+	struct FCachedSpec
+	{
+		TSubclassOf<UGameplayEffect> EffectClass;
+		float Damage;
+		FGameplayEffectSpec Spec;
+	};
+
+	TArray<TWeakObjectPtr<AGamePlayerCharacter>> Players;
+
+	// One spec per damage effect class and damage level, reused by every pass
+	TArray<FCachedSpec> CachedSpecs;
+
+	// Zone damage has no instigator, so a single context without source is shared by every spec. An effect
+	// capturing source attributes, like one executing UDamageGE_ExecutionCalculation, finds nothing to capture
+	FGameplayEffectContextHandle SharedContext;
+
+	bool bApplyDirectly;
+
+	TSubclassOf<UGameplayEffect> EffectClass;
+
+	float StepInterval;
+
+	int32 MaxStepsPerFrame;
+
+	float Accumulator;
+
+	double LastPassSeconds;
+
+	double AveragePassSeconds;
+
+	int32 LastPassApplications;
+};
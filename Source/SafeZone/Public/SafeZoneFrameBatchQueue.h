@@ -0,0 +1,84 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Engine/World.h"
+
+/**
+ * Elements queued during a frame and handed out together once the actors of the world ticked, so they can go
+ * out in one RPC. A batch holds at most MaxPerBatch elements, the rest waits for the next frame. Used by
+ * the server for the cosmetic events of the game state and the local gameplay cues of the player controllers.
+ */
+template<typename ElementType>
+class TSafeZoneFrameBatchQueue
+{
+public:
+	~TSafeZoneFrameBatchQueue()
+	{
+		Stop();
+	}
+
+	// Calls SendBatch with the batches of World from now on, the owner stops the queue before it goes away
+	void Start(UWorld* InWorld, int32 InMaxPerBatch, TFunction<void(const TArray<ElementType>&)> InSendBatch)
+	{
+		Stop();
+
+		World = InWorld;
+		MaxPerBatch = FMath::Max(InMaxPerBatch, 1);
+		SendBatch = MoveTemp(InSendBatch);
+		PostActorTickHandle = FWorldDelegates::OnWorldPostActorTick.AddRaw(this, &TSafeZoneFrameBatchQueue::Flush);
+	}
+
+	void Stop()
+	{
+		if (PostActorTickHandle.IsValid())
+		{
+			FWorldDelegates::OnWorldPostActorTick.Remove(PostActorTickHandle);
+			PostActorTickHandle.Reset();
+		}
+		SendBatch = nullptr;
+	}
+
+	ElementType& Add()
+	{
+		return Pending.AddDefaulted_GetRef();
+	}
+
+	// Drops the elements not sent yet
+	void Reset()
+	{
+		Pending.Reset();
+	}
+
+private:
+	void Flush(UWorld* TickedWorld, ELevelTick TickType, float DeltaSeconds)
+	{
+		if (TickedWorld != World || Pending.Num() == 0 || !SendBatch)
+		{
+			return;
+		}
+
+		const int32 NumElements = FMath::Min(Pending.Num(), MaxPerBatch);
+		if (NumElements == Pending.Num())
+		{
+			SendBatch(Pending);
+			Pending.Reset();
+		}
+		else
+		{
+			SendBatch(TArray<ElementType>(Pending.GetData(), NumElements));
+			Pending.RemoveAt(0, NumElements, false);
+		}
+	}
+
+	UWorld* World = nullptr;
+
+	int32 MaxPerBatch = 1;
+
+	TArray<ElementType> Pending;
+
+	TFunction<void(const TArray<ElementType>&)> SendBatch;
+
+	FDelegateHandle PostActorTickHandle;
+};
@@ -1,63 +1,259 @@
-// Fill out your copyright notice in the Description page of Project Settings.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "GameFramework/GameMode.h"
-#include "SafeZoneGameMode.generated.h"
-
-/**
- * 
- */
-
-class AQuadrantSystemActor;
-class ASafeZoneActor;
-class AGamePlayerCharacter;
-
-UCLASS()
-class SAFEZONE_API ASafeZoneGameMode : public AGameMode
-{
-	GENERATED_BODY()
-
-	ASafeZoneGameMode();
-
-	TMap<FString, AQuadrantSystemActor*> PlayerQuadrantMap;
-
-	AQuadrantSystemActor* currentPlayerQuadrant;
-
-protected:
-
-	virtual void BeginPlay() override;
-
-	virtual void PostLogin(APlayerController* NewPlayer) override;
-
-	virtual void Logout(AController* Exiting) override;
-public:
-	void UpdatePlayerQuadrant(FString PlayerID, AQuadrantSystemActor* Quadrant);
-	
-	void StartQuadrantUpdateDelay(FString PlayerID, float DelayTime);
-
-	void ManagePlayerCount();
-
-	UPROPERTY(BlueprintReadWrite,EditAnywhere,Category = "Map SafeZone")
-	ASafeZoneActor* safeZoneActor_Ref;
-
-private:
-	void DelayedUpdatePlayerQuadrant(FString PlayerID);
-
-	void RemoveOutsideSafeZoneTagIfApplicable(const FString& PlayerID);
-
-	void ApplyOutsideSafeZoneTagIfApplicable(const FString& PlayerID);
-
-	bool IsPlayerInSafeZone(AGamePlayerCharacter* PlayerCharacter);
-
-	AGamePlayerCharacter* GetPlayerCharacterFromID(const FString& PlayerID);
-
-	bool IsPlayerInAnyQuadrant(const FString& PlayerID);
-
-	AQuadrantSystemActor* FindCurrentQuadrantOfPlayer(const FString& PlayerID) const;
-
-	ASafeZoneActor* SpawnSafeZoneActor();
-
-	void EndGame();
-};
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameMode.h"
+#include "SafeZoneMembership.h"
+#include "SafeZoneDamageScheduler.h"
+#include "SafeZonePlayerRegistry.h"
+#include "SafeZoneCharacterPool.h"
+#include "SafeZoneGameMode.generated.h"
+
+/**
+ * 
+ */
+
+class ASafeZoneActor;
+class AGamePlayerCharacter;
+
+UCLASS()
+class SAFEZONE_API ASafeZoneGameMode : public AGameMode
+{
+	GENERATED_BODY()
+
+	ASafeZoneGameMode();
+
+protected:
+
+	virtual void BeginPlay() override;
+
+	virtual void PostLogin(APlayerController* NewPlayer) override;
+
+	virtual void Logout(AController* Exiting) override;
+
+	virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
+	// Takes player characters from the pool before spawning new ones
+	virtual APawn* SpawnDefaultPawnAtTransform_Implementation(AController* NewPlayer, const FTransform& SpawnTransform) override;
+
+	// Queued while the match start pipeline runs, spawned within the per frame budget
+	virtual void RestartPlayer(AController* NewPlayer) override;
+public:
+	// Queues the initialization of a match participant's character while the match start pipeline runs,
+	// returns false if the character should initialize right away
+	bool DeferCharacterInitialization(AGamePlayerCharacter* PlayerCharacter);
+
+	bool IsMatchStartPipelineDone() const { return bMatchStartPipelineDone; }
+
+	// Rewinds the match on the running level: characters go back to the pool, the zone, registry state, game state
+	// and match start pipeline are reset, and every connected player is restarted. Server only
+	void ResetMatch();
+
+	// Duration of the synchronous part of the last ResetMatch in milliseconds
+	UFUNCTION(BlueprintCallable, Category = "Map SafeZone")
+	float GetLastMatchResetMs() const { return LastMatchResetMs; }
+
+	// Remembers when a full level reload was requested, the next game mode logs how long it took to begin play
+	static void MarkLevelReloadStart();
+
+	// Wall time from the first queued join to the last initialized character, 0 until the pipeline is done
+	UFUNCTION(BlueprintCallable, Category = "Map SafeZone")
+	float GetMatchStartInitSeconds() const { return MatchStartInitSeconds; }
+
+	// The default pawn class if it is a game character, AGamePlayerCharacter otherwise. For characters spawned outside RestartPlayer
+	TSubclassOf<AGamePlayerCharacter> GetPlayerCharacterClass() const;
+
+	// Reuses a pooled character of the class if there is one, spawns a new one otherwise
+	AGamePlayerCharacter* SpawnPlayerCharacter(TSubclassOf<AGamePlayerCharacter> CharacterClass, const FTransform& SpawnTransform);
+
+	// Unbinds the unpossessed character from the registry and pools it, or destroys it when pooling is off
+	void ReleasePlayerCharacter(AGamePlayerCharacter* PlayerCharacter);
+
+	FSafeZoneCharacterPool& GetCharacterPool() { return CharacterPool; }
+
+	// Gives the controller a registry handle and adds it alive to the roster, returns the handle
+	int32 RegisterPlayerController(AController* Controller);
+
+	// Binds a freshly possessed character to the registry handle of its controller
+	void RegisterPlayerCharacter(AGamePlayerCharacter* PlayerCharacter);
+
+	FSafeZonePlayerRegistry& GetPlayerRegistry() { return PlayerRegistry; }
+
+	// Update the registry and the replicated player slot bits of the game state together
+	void SetPlayerKnocked(int32 PlayerHandle, bool bKnocked);
+
+	void SetPlayerDead(int32 PlayerHandle);
+
+	// Ends the match once nobody is left alive on the roster
+	void ManagePlayerCount();
+
+	// Primary safe zone from USafeZoneSubsystem, its shrink iteration drives the zone damage. Every registered zone
+	// takes part in the membership pass
+	UPROPERTY(BlueprintReadWrite,EditAnywhere,Category = "Map SafeZone")
+	ASafeZoneActor* safeZoneActor_Ref;
+
+	FSafeZoneDamageScheduler& GetZoneDamageScheduler() { return ZoneDamageScheduler; }
+
+	// Duration of the last zone damage pass in milliseconds
+	UFUNCTION(BlueprintCallable, Category = "Map SafeZone")
+	float GetLastZoneDamagePassMs() const;
+
+	// Moving average of the zone damage pass duration in milliseconds
+	UFUNCTION(BlueprintCallable, Category = "Map SafeZone")
+	float GetAverageZoneDamagePassMs() const;
+
+	// Players in the Outside zone state after the last membership pass
+	UFUNCTION(BlueprintCallable, Category = "Map SafeZone")
+	int32 GetNumPlayersOutside() const { return NumPlayersOutside; }
+
+	// Zone damage effects applied per second, measured over the last second
+	UFUNCTION(BlueprintCallable, Category = "Map SafeZone")
+	float GetDamageApplicationsPerSecond() const { return DamageApplicationsPerSecond; }
+
+	// Zone state changes per second, measured over the last second
+	UFUNCTION(BlueprintCallable, Category = "Map SafeZone")
+	float GetMembershipTransitionsPerSecond() const { return MembershipTransitionsPerSecond; }
+
+protected:
+	// How many times per second the server resolves which players are inside the safe zone
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Map SafeZone")
+	float MembershipUpdateRate;
+
+	// Distance beyond the zone radius a player inside has to cross before its grace time starts
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Map SafeZone")
+	float ZoneExitHysteresis;
+
+	// Time a player has to stay beyond the exit distance before the outside safe zone tag is applied
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Map SafeZone")
+	float ZoneExitGraceTime;
+
+	// Fixed step in seconds between two zone damage passes
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Map SafeZone")
+	float ZoneDamageInterval;
+
+	// Damage per step for every shrink iteration, the last entry is used for later iterations
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Map SafeZone")
+	TArray<float> ZoneDamagePerPhase;
+
+	// Effect the zone damage applies with the damage as Data.Damage SetByCaller. Zone damage has no instigator,
+	// so the effect can't capture source attributes
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Map SafeZone")
+	TSubclassOf<class UGameplayEffect> ZoneDamageEffectClass;
+
+	// Zone damage lowers the health attribute directly instead of applying ZoneDamageEffectClass.
+	// Allocation free, but the effect's executions, cues and callbacks don't run for zone damage
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Map SafeZone")
+	bool bApplyZoneDamageDirectly;
+
+	// Time per frame spent on queued joins and character initialization at match start, at least one item runs per frame
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Map SafeZone")
+	float MatchStartInitBudgetMs;
+
+	// After EndGame the next match starts on the same level through ResetMatch instead of sending the players back to the main menu
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Map SafeZone")
+	bool bResetMatchInPlace;
+
+	// Seconds between the end of a match and the in place reset, 0 resets on the next frame
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Map SafeZone")
+	float PostMatchDelay;
+
+	// Dead characters are hidden and reused on respawn instead of destroyed and spawned again
+	UPROPERTY(EditDefaultsOnly, BlueprintReadOnly, Category = "Map SafeZone")
+	bool bPoolPlayerCharacters;
+
+	virtual void Tick(float DeltaSeconds) override;
+
+private:
+	// Batched inside/outside test of every live character against the circles of all registered zones
+	void UpdateZoneMembership();
+
+	// Zones register with USafeZoneSubsystem on begin play, before or after the game mode
+	void HandleZoneRegistered(ASafeZoneActor* Zone);
+
+	void HandleZoneUnregistered(ASafeZoneActor* Zone);
+
+	FDelegateHandle ZoneRegisteredHandle;
+
+	FDelegateHandle ZoneUnregisteredHandle;
+
+	void RemovePlayerFromGrid(int32 PlayerHandle);
+
+	float GetZoneDamageForCurrentPhase() const;
+
+	FSafeZoneDamageScheduler ZoneDamageScheduler;
+
+	FSafeZonePlayerRegistry PlayerRegistry;
+
+	FSafeZoneCharacterPool CharacterPool;
+
+	// Runs queued restarts and character initializations until the frame budget is spent, activates the zone once drained
+	void ProcessMatchStartPipeline();
+
+	TArray<TWeakObjectPtr<AController>> PendingRestarts;
+
+	TArray<TWeakObjectPtr<AGamePlayerCharacter>> PendingInitializations;
+
+	bool bMatchStartPipelineDone;
+
+	// Set while the pipeline itself restarts a player, so the restart isn't queued again
+	bool bRunningMatchStartPipeline;
+
+	double MatchStartQueueTime;
+
+	int32 MatchStartFrames;
+
+	int32 MatchStartInitializedCharacters;
+
+	float MatchStartMaxFrameMs;
+
+	float MatchStartInitSeconds;
+
+	float LastMatchResetMs;
+
+	FTimerHandle MatchResetTimerHandle;
+
+	FTimerHandle MembershipTimerHandle;
+
+	FSafeZoneMembershipBatch MembershipBatch;
+
+	// Player handles in the order they were added to MembershipBatch
+	TArray<int32> MembershipHandles;
+
+	// Two circles per zone, bit 2 * Zone for the zone radius and bit 2 * Zone + 1 for the radius moved by ZoneExitHysteresis
+	// towards the outside of the zone (wider for safe zones, narrower for hazard zones)
+	TArray<FVector2D> ZoneCircleCenters;
+
+	TArray<float> ZoneCircleRadii;
+
+	// Per batch entry, the circles of ZoneCircleCenters the position is inside
+	TArray<uint32> ZoneCircleMasks;
+
+	TArray<uint8> QuadrantInsideFlags;
+
+	// Steps the Inside/Grace/Outside state machine of one player, the tag only changes when Outside is entered or left
+	void AdvanceZoneState(int32 PlayerHandle, bool bInsideEnterRadius, bool bInsideStayRadius, float WorldTime);
+
+	void SetOutsideSafeZoneTag(int32 PlayerHandle, bool bOutside);
+
+	// Turns the counts of the current one second window into the per second stats
+	void UpdateSafeZoneStats(float DeltaSeconds);
+
+	int32 NumPlayersOutside;
+
+	int32 NumPlayersInGrace;
+
+	int32 DamageApplicationsInWindow;
+
+	int32 MembershipTransitionsInWindow;
+
+	float StatsWindowTime;
+
+	float DamageApplicationsPerSecond;
+
+	float MembershipTransitionsPerSecond;
+
+	ASafeZoneActor* SpawnSafeZoneActor();
+
+	void EndGame();
+};
@@ -4,8 +4,56 @@
 
 #include "CoreMinimal.h"
 #include "GameFramework/GameState.h"
+#include "SafeZoneRoster.h"
+#include "SafeZoneFrameBatchQueue.h"
 #include "SafeZoneGameState.generated.h"
 
+// Per player state replicated as one bit per player slot, the slot is the registry handle of the player
+UENUM(BlueprintType)
+enum class ESafeZonePlayerSlotFlag : uint8
+{
+    Outside,
+    Knocked,
+    Dead,
+};
+
+// One shot notifications for kill feeds, sounds and the like. The state itself replicates on its own
+UENUM(BlueprintType)
+enum class ESafeZoneCosmeticEventType : uint8
+{
+    Knockdown,
+    Death,
+};
+
+USTRUCT(BlueprintType)
+struct FSafeZoneCosmeticEvent
+{
+    GENERATED_BODY()
+
+    UPROPERTY(BlueprintReadOnly, Category = "Cosmetic Events")
+    ESafeZoneCosmeticEventType Type;
+
+    // Registry handle of the player the event happened to
+    UPROPERTY(BlueprintReadOnly, Category = "Cosmetic Events")
+    int32 PlayerHandle;
+
+    UPROPERTY(BlueprintReadOnly, Category = "Cosmetic Events")
+    float ServerTime;
+
+    FSafeZoneCosmeticEvent()
+        : Type(ESafeZoneCosmeticEventType::Knockdown)
+        , PlayerHandle(INDEX_NONE)
+        , ServerTime(0.0f)
+    {
+    }
+};
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnPlayerSlotStatesChanged);
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE(FOnRosterChanged);
+
+DECLARE_DYNAMIC_MULTICAST_DELEGATE_OneParam(FOnCosmeticEvent, const FSafeZoneCosmeticEvent&, Event);
+
 /**
  * 
  */
@@ -15,15 +63,99 @@ class SAFEZONE_API ASafeZoneGameState : public AGameState
 	GENERATED_BODY()
 
 	public:
-    UPROPERTY(ReplicatedUsing = OnRep_PlayerCount)
-    int32 PlayerCount;
-
-    UFUNCTION()
-    void OnRep_PlayerCount();
+    ASafeZoneGameState();
 
+    // Players still alive, derived from the roster
     UFUNCTION(BlueprintCallable, Category = "PlayerCount in Game")
-    int32 GetPlayerCount() const { return PlayerCount; }
+    int32 GetPlayerCount() const { return Roster.GetNumAlive(); }
+
+    // Server only, see FSafeZoneRoster
+    FSafeZoneRoster& GetRoster() { return Roster; }
+
+    UFUNCTION(BlueprintCallable, Category = "Roster")
+    const TArray<FSafeZoneRosterEntry>& GetRosterEntries() const { return Roster.GetEntries(); }
+
+    // Final standing of the player, 0 while it is still alive and not the last one
+    UFUNCTION(BlueprintCallable, Category = "Roster")
+    int32 GetPlacement(int32 PlayerHandle) const;
+
+    // Broadcast on clients whenever roster entries have been added, changed or removed
+    UPROPERTY(BlueprintAssignable, Category = "Roster")
+    FOnRosterChanged OnRosterChanged;
+
+    void NotifyRosterChanged();
+
+    // Server only. Events queued during a frame go out together in one unreliable multicast after the actors ticked
+    void QueueCosmeticEvent(ESafeZoneCosmeticEventType Type, int32 PlayerHandle);
+
+    // Broadcast on every machine for each received event, dropped batches are not resent
+    UPROPERTY(BlueprintAssignable, Category = "Cosmetic Events")
+    FOnCosmeticEvent OnCosmeticEvent;
+
+    // Server only, slots grow on demand and are never shrunk
+    void SetPlayerSlotFlag(int32 Slot, ESafeZonePlayerSlotFlag Flag, bool bValue);
+
+    // Server only, clears every flag of a slot when its player respawns or leaves
+    void ClearPlayerSlot(int32 Slot);
+
+    // Server only, empties the slot bits, the roster and the pending cosmetic events for a match reset
+    void ResetMatchState();
+
+    UFUNCTION(BlueprintCallable, Category = "Player Slots")
+    bool HasPlayerSlotFlag(int32 Slot, ESafeZonePlayerSlotFlag Flag) const;
+
+    UFUNCTION(BlueprintCallable, Category = "Player Slots")
+    bool IsPlayerOutside(int32 Slot) const { return HasPlayerSlotFlag(Slot, ESafeZonePlayerSlotFlag::Outside); }
+
+    UFUNCTION(BlueprintCallable, Category = "Player Slots")
+    bool IsPlayerKnocked(int32 Slot) const { return HasPlayerSlotFlag(Slot, ESafeZonePlayerSlotFlag::Knocked); }
+
+    UFUNCTION(BlueprintCallable, Category = "Player Slots")
+    bool IsPlayerDead(int32 Slot) const { return HasPlayerSlotFlag(Slot, ESafeZonePlayerSlotFlag::Dead); }
+
+    UFUNCTION(BlueprintCallable, Category = "Player Slots")
+    int32 GetNumPlayersWithFlag(ESafeZonePlayerSlotFlag Flag) const;
+
+    // Broadcast on clients whenever one of the slot bit arrays has been received
+    UPROPERTY(BlueprintAssignable, Category = "Player Slots")
+    FOnPlayerSlotStatesChanged OnPlayerSlotStatesChanged;
 
 protected:
+    virtual void BeginPlay() override;
+
+    virtual void EndPlay(const EEndPlayReason::Type EndPlayReason) override;
+
     virtual void GetLifetimeReplicatedProps(TArray< FLifetimeProperty >& OutLifetimeProps) const override;
-};
\ No newline at end of file
+
+    UPROPERTY(Replicated)
+    FSafeZoneRoster Roster;
+
+    // 32 slots per word. Arrays replicate per element, so only the words that changed are sent
+    UPROPERTY(ReplicatedUsing = OnRep_PlayerSlotBits)
+    TArray<uint32> OutsideBits;
+
+    UPROPERTY(ReplicatedUsing = OnRep_PlayerSlotBits)
+    TArray<uint32> KnockedBits;
+
+    UPROPERTY(ReplicatedUsing = OnRep_PlayerSlotBits)
+    TArray<uint32> DeadBits;
+
+    UFUNCTION()
+    void OnRep_PlayerSlotBits();
+
+    UFUNCTION(NetMulticast, Unreliable)
+    void MulticastCosmeticEvents(const TArray<FSafeZoneCosmeticEvent>& Events);
+
+    // Upper bound of events per multicast
+    UPROPERTY(EditDefaultsOnly, Category = "Cosmetic Events")
+    int32 MaxCosmeticEventsPerBatch;
+
+private:
+    TSafeZoneFrameBatchQueue<FSafeZoneCosmeticEvent> PendingCosmeticEvents;
+
+    const TArray<uint32>& GetSlotBits(ESafeZonePlayerSlotFlag Flag) const;
+
+    TArray<uint32>& GetSlotBits(ESafeZonePlayerSlotFlag Flag);
+
+    void MarkSlotBitsDirty(ESafeZonePlayerSlotFlag Flag);
+};
@@ -0,0 +1,61 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayTagContainer.h"
+
+/**
+ * Native gameplay tags of the game, one member per tag of DefaultGameplayTags.ini. Registered with the
+ * tags manager on the first Get(), at the latest when the game module starts, while native tags can still
+ * be added, so code uses the members instead of looking tags up by name. Class default objects of the
+ * module are built before the module starts, so constructors still don't read the tags: classes resolve
+ * them in PostInitProperties or on first use.
+ */
+struct SAFEZONE_API FSafeZoneGameplayTags
+{
+public:
+	static const FSafeZoneGameplayTags& Get()
+	{
+		if (!GameplayTags.bInitialized)
+		{
+			InitializeNativeTags();
+		}
+		return GameplayTags;
+	}
+
+	// Adds every tag as a native tag, does nothing once done. Called from the startup of the game module
+	static void InitializeNativeTags();
+
+	FGameplayTag Activation_Fail_BlockedByTags;
+	FGameplayTag Activation_Fail_CantAffordCost;
+	FGameplayTag Activation_Fail_IsDead;
+	FGameplayTag Activation_Fail_MissingTags;
+	FGameplayTag Activation_Fail_Networking;
+	FGameplayTag Activation_Fail_OnCooldown;
+
+	// SetByCaller magnitude of the zone damage
+	FGameplayTag Data_Damage;
+
+	FGameplayTag Effect_RemoveOnDeath;
+
+	FGameplayTag Event_EndAbility;
+
+	// Executed locally on the owning client, see AGamePlayerController::QueueLocalGameplayCue
+	FGameplayTag GameplayCue_SafeZone_Damage;
+	FGameplayTag GameplayCue_SafeZone_Entered;
+	FGameplayTag GameplayCue_SafeZone_Exited;
+
+	FGameplayTag State_Dead;
+	FGameplayTag State_KnockedDown;
+	FGameplayTag State_OutsideSafeZone;
+
+	FGameplayTag Weapon_Fail_Activation_OnCooldown;
+
+private:
+	void AddTag(FGameplayTag& OutTag, const ANSICHAR* TagName, const ANSICHAR* TagComment);
+
+	bool bInitialized = false;
+
+	static FSafeZoneGameplayTags GameplayTags;
+};
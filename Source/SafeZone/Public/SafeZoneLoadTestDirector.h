@@ -0,0 +1,98 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/Actor.h"
+#include "SafeZoneLoadTestDirector.generated.h"
+
+class AAIController;
+class ASafeZoneGameMode;
+
+/**
+ * Server side load test. Spawns a swarm of server driven characters that keep walking across the zone
+ * boundary, waits for the full shrink schedule and writes frame time percentiles together with the
+ * SafeZone stat counters to a json report in Saved/Profiling/SafeZone.
+ *
+ * Started from the command line of a dedicated server:
+ *   SafeZoneServer Start_Level -log -nullrhi -SafeZoneLoadTest=100 [-SafeZoneLoadTestMaxSeconds=600] [-SafeZoneLoadTestNoExit]
+ */
+UCLASS(NotBlueprintable, NotPlaceable)
+class SAFEZONE_API ASafeZoneLoadTestDirector : public AActor
+{
+	GENERATED_BODY()
+
+public:
+	ASafeZoneLoadTestDirector();
+
+	// Spawns a director if the command line asks for a load test, does nothing in shipping builds
+	static void StartFromCommandLine(ASafeZoneGameMode* InGameMode);
+
+	virtual void Tick(float DeltaSeconds) override;
+
+protected:
+	virtual void BeginPlay() override;
+
+private:
+	struct FBot
+	{
+		TWeakObjectPtr<AAIController> Controller;
+
+		// Direction from the zone center the bot walks along, slowly rotating
+		float Angle;
+
+		// Offset of the bot in the in/out cycle, so the swarm doesn't cross the boundary all at once
+		float Phase;
+	};
+
+	void SpawnBots();
+
+	void SpawnBotPawn(FBot& Bot);
+
+	void DriveBots(float DeltaSeconds);
+
+	void RecordFrame();
+
+	void FinishRun();
+
+	void WriteReport() const;
+
+	TArray<FBot> Bots;
+
+	UPROPERTY()
+	ASafeZoneGameMode* GameMode;
+
+	int32 NumBots;
+
+	float MaxDuration;
+
+	bool bExitWhenDone;
+
+	float ElapsedTime;
+
+	bool bFinished;
+
+	bool bCompletedShrink;
+
+	float SpawnHeight;
+
+	// Seeded with the bot count so runs with the same count drive the same movement
+	FRandomStream RandomStream;
+
+	// Full frame time and frame time without the idle wait for the server tick rate
+	TArray<float> FrameTimesMs;
+
+	TArray<float> FrameWorkTimesMs;
+
+	double PlayersOutsideSum;
+
+	int32 PlayersOutsideMax;
+
+	double DamageApplicationsPerSecondSum;
+
+	double MembershipTransitionsPerSecondSum;
+
+	double DamagePassMsSum;
+
+	int32 NumBotRespawns;
+};
@@ -0,0 +1,47 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Batch of player positions kept as contiguous X/Y arrays so the inside/outside tests against the
+ * zone circles run four players at a time. Filled once per membership pass on the server.
+ */
+struct SAFEZONE_API FSafeZoneMembershipBatch
+{
+public:
+	FSafeZoneMembershipBatch();
+
+	// Clears the batch, keeps the allocations
+	void Reset();
+
+	// Adds a position, returns its index
+	int32 Add(const FVector& Position);
+
+	int32 Num() const
+	{
+		return PositionX.Num();
+	}
+
+	// Tests every position against the circle
+	void TestCircle(const FVector2D& Center, float Radius, TArray<uint8>& OutInside) const;
+
+	// Tests every position against all circles in one pass over the positions. Bit N of a position's mask is set
+	// when it is inside circle N, so at most MaxCircles circles
+	void TestCircles(const TArray<FVector2D>& Centers, const TArray<float>& Radii, TArray<uint32>& OutMasks) const;
+
+	// The position arrays must be 16 byte aligned
+	static void TestCircles(const float* InPositionX, const float* InPositionY, int32 NumPositions, const FVector2D* Centers, const float* Radii, int32 NumCircles, uint32* OutMasks);
+
+	static constexpr int32 MaxCircles = 32;
+
+	// Vectorized distance squared test, writes 1 for every position inside the circle and 0 otherwise.
+	// The position arrays must be 16 byte aligned
+	static void TestCircle(const float* InPositionX, const float* InPositionY, int32 NumPositions, const FVector2D& Center, float Radius, uint8* OutInside);
+
+private:
+	// 16 byte aligned so the kernel can use aligned loads
+	TArray<float, TAlignedHeapAllocator<16>> PositionX;
+	TArray<float, TAlignedHeapAllocator<16>> PositionY;
+};
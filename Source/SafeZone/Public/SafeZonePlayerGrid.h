@@ -0,0 +1,93 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+/**
+ * Uniform 2D grid over the safe zone that keeps track of which cell every player is in.
+ * Each cell holds an intrusive linked list of items, so moving a player between cells is O(1)
+ * and density queries only touch the cells they overlap instead of iterating actors.
+ */
+struct SAFEZONE_API FSafeZonePlayerGrid
+{
+public:
+	FSafeZonePlayerGrid();
+
+	// Covers the square of the given half extent around Center and drops all items
+	void Initialize(const FVector2D& Center, float HalfExtent, float InCellSize);
+
+	bool IsInitialized() const
+	{
+		return CellHeads.Num() > 0;
+	}
+
+	// Returns the id of the new item, ids are reused after RemoveItem
+	int32 AddItem(const FVector2D& Position);
+
+	void MoveItem(int32 ItemId, const FVector2D& Position);
+
+	void RemoveItem(int32 ItemId);
+
+	int32 GetNumItems() const
+	{
+		return NumItems;
+	}
+
+	int32 GetNumCells() const
+	{
+		return CellHeads.Num();
+	}
+
+	// Number of items in the rectangle
+	int32 CountInRect(const FBox2D& Rect) const;
+
+	// Number of items within Radius of Center
+	int32 CountInRadius(const FVector2D& Center, float Radius) const;
+
+	// Ids of the items within Radius of Center
+	void GetItemsInRadius(const FVector2D& Center, float Radius, TArray<int32>& OutItemIds) const;
+
+	/**
+	 * Finds the circle of RegionRadius that contains the fewest items and fits inside the circle of
+	 * SearchRadius around SearchCenter. Candidates are the cell centers, ties are broken randomly.
+	 */
+	FVector2D FindLeastPopulatedRegion(const FVector2D& SearchCenter, float SearchRadius, float RegionRadius) const;
+
+private:
+	int32 GetCellIndex(const FVector2D& Position) const;
+
+	void GetCellRange(const FBox2D& Rect, int32& OutMinX, int32& OutMinY, int32& OutMaxX, int32& OutMaxY) const;
+
+	FVector2D GetCellCenter(int32 CellX, int32 CellY) const;
+
+	void LinkItem(int32 ItemId, int32 CellIndex);
+
+	void UnlinkItem(int32 ItemId);
+
+	FVector2D Origin;
+
+	float CellSize;
+
+	int32 NumCellsX;
+
+	int32 NumCellsY;
+
+	int32 NumItems;
+
+	// First item of every cell, INDEX_NONE when the cell is empty
+	TArray<int32> CellHeads;
+
+	TArray<int32> CellCounts;
+
+	// Per item data, indexed by item id
+	TArray<FVector2D> ItemPositions;
+
+	TArray<int32> ItemCells;
+
+	TArray<int32> ItemNext;
+
+	TArray<int32> ItemPrev;
+
+	TArray<int32> FreeItemIds;
+};
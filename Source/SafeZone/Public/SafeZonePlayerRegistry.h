@@ -0,0 +1,181 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+
+class AController;
+class AGamePlayerCharacter;
+
+// Zone state of a registered player, advanced by the membership pass.
+// Grace is the time between crossing the exit distance and being treated as outside.
+enum class ESafeZonePlayerZoneState : uint8
+{
+	Inside,
+	Grace,
+	Outside
+};
+
+/**
+ * Server side table of connected players. Every player gets a dense integer handle on login that is
+ * freed on logout, and the hot per-player data is kept in one array per field indexed by that handle.
+ * The unique net id string is only built at the edges, for logging and lookups from outside the module.
+ */
+class SAFEZONE_API FSafeZonePlayerRegistry
+{
+public:
+	FSafeZonePlayerRegistry();
+
+	// Returns the handle of the controller, allocating one if it has none yet
+	int32 AllocateHandle(AController* Controller);
+
+	void FreeHandle(int32 Handle);
+
+	// Frees every handle
+	void Reset();
+
+	bool IsValidHandle(int32 Handle) const
+	{
+		return Flags.IsValidIndex(Handle) && (Flags[Handle] & Flag_InUse) != 0;
+	}
+
+	int32 FindHandle(const AController* Controller) const;
+
+	// Linear search on the unique net id, for callers that only have the string
+	int32 FindHandleByPlayerId(const FString& PlayerId) const;
+
+	FString GetPlayerId(int32 Handle) const;
+
+	int32 GetNumPlayers() const
+	{
+		return NumPlayers;
+	}
+
+	// Upper bound of the handles in use, iterate up to it and skip invalid handles
+	int32 GetNumHandles() const
+	{
+		return Flags.Num();
+	}
+
+	// Binds the possessed character and resets its state to alive, inside and at full health
+	void BindCharacter(int32 Handle, AGamePlayerCharacter* PlayerCharacter, float Health);
+
+	AGamePlayerCharacter* GetCharacter(int32 Handle) const
+	{
+		return Characters[Handle].Get();
+	}
+
+	AController* GetController(int32 Handle) const
+	{
+		return Controllers[Handle].Get();
+	}
+
+	const FVector& GetPosition(int32 Handle) const
+	{
+		return Positions[Handle];
+	}
+
+	void SetPosition(int32 Handle, const FVector& Position)
+	{
+		Positions[Handle] = Position;
+	}
+
+	ESafeZonePlayerZoneState GetZoneState(int32 Handle) const
+	{
+		return ZoneStates[Handle];
+	}
+
+	void SetZoneState(int32 Handle, ESafeZonePlayerZoneState ZoneState)
+	{
+		ZoneStates[Handle] = ZoneState;
+	}
+
+	// World time at which a player in Grace becomes Outside
+	float GetGraceEndTime(int32 Handle) const
+	{
+		return GraceEndTimes[Handle];
+	}
+
+	void SetGraceEndTime(int32 Handle, float Time)
+	{
+		GraceEndTimes[Handle] = Time;
+	}
+
+	float GetHealth(int32 Handle) const
+	{
+		return Healths[Handle];
+	}
+
+	void SetHealth(int32 Handle, float Health)
+	{
+		Healths[Handle] = Health;
+	}
+
+	bool IsAlive(int32 Handle) const
+	{
+		return (Flags[Handle] & Flag_Alive) != 0;
+	}
+
+	void SetAlive(int32 Handle, bool bAlive)
+	{
+		SetFlag(Handle, Flag_Alive, bAlive);
+	}
+
+	bool IsKnocked(int32 Handle) const
+	{
+		return (Flags[Handle] & Flag_Knocked) != 0;
+	}
+
+	void SetKnocked(int32 Handle, bool bKnocked)
+	{
+		SetFlag(Handle, Flag_Knocked, bKnocked);
+	}
+
+	// First quadrant the player occupied in the last membership pass, INDEX_NONE when outside every quadrant
+	int32 GetQuadrant(int32 Handle) const
+	{
+		return Quadrants[Handle];
+	}
+
+	void SetQuadrant(int32 Handle, int32 QuadrantIndex)
+	{
+		Quadrants[Handle] = QuadrantIndex;
+	}
+
+private:
+	enum EPlayerFlags : uint8
+	{
+		Flag_InUse = 1 << 0,
+		Flag_Alive = 1 << 1,
+		Flag_Knocked = 1 << 2
+	};
+
+	void SetFlag(int32 Handle, uint8 Flag, bool bValue)
+	{
+		Flags[Handle] = bValue ? (Flags[Handle] | Flag) : (Flags[Handle] & ~Flag);
+	}
+
+	void ResetSlot(int32 Handle);
+
+	TArray<TWeakObjectPtr<AController>> Controllers;
+
+	TArray<TWeakObjectPtr<AGamePlayerCharacter>> Characters;
+
+	TArray<FVector> Positions;
+
+	TArray<ESafeZonePlayerZoneState> ZoneStates;
+
+	TArray<float> GraceEndTimes;
+
+	TArray<float> Healths;
+
+	TArray<uint8> Flags;
+
+	TArray<int32> Quadrants;
+
+	TArray<int32> FreeHandles;
+
+	TMap<const AController*, int32> ControllerHandles;
+
+	int32 NumPlayers;
+};
@@ -0,0 +1,126 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "ReplicationGraph.h"
+#include "SafeZoneReplicationGraph.generated.h"
+
+class UReplicationGraphNode_GridSpatialization2D;
+class UReplicationGraphNode_ActorList;
+
+// How actors of a class are routed into the graph
+enum class ESafeZoneClassRepNodeMapping : uint32
+{
+	// Not replicated through a node, server only actors or actors gathered by a per connection node
+	NotRouted,
+	// Replicated to every connection
+	RelevantAllConnections,
+	// Spatialized actors that never move
+	Spatialize_Static,
+	// Spatialized actors that move every frame
+	Spatialize_Dynamic,
+	// Spatialized actors that move while awake and can go dormant
+	Spatialize_Dormancy,
+};
+
+/**
+ * Replication graph of the SafeZone game. Characters are spatialized in a 2D grid, the safe zone and the
+ * game state are relevant to every connection, and quadrants never reach the graph. Far away characters
+ * are replicated to a connection every few frames only, see USafeZoneReplicationGraphNode_DistanceThrottle.
+ *
+ * Enabled with ReplicationDriverClassName in the IpNetDriver section of DefaultEngine.ini.
+ */
+UCLASS(Transient, Config = Engine)
+class SAFEZONE_API USafeZoneReplicationGraph : public UReplicationGraph
+{
+	GENERATED_BODY()
+
+public:
+	USafeZoneReplicationGraph();
+
+	virtual void InitGlobalActorClassSettings() override;
+
+	virtual void InitGlobalGraphNodes() override;
+
+	virtual void InitConnectionGraphNodes(UNetReplicationGraphConnection* RepGraphConnection) override;
+
+	virtual void RouteAddNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo, FGlobalActorReplicationInfo& GlobalInfo) override;
+
+	virtual void RouteRemoveNetworkActorToNodes(const FNewReplicatedActorInfo& ActorInfo) override;
+
+	UPROPERTY()
+	UReplicationGraphNode_GridSpatialization2D* GridNode;
+
+	UPROPERTY()
+	UReplicationGraphNode_ActorList* AlwaysRelevantNode;
+
+	UPROPERTY()
+	class USafeZoneReplicationGraphNode_DistanceThrottle* DistanceThrottleNode;
+
+	// Size of a spatialization grid cell
+	UPROPERTY(Config)
+	float GridCellSize;
+
+	// Lowest world X/Y the grid expects, actors below it are clamped into the border cells
+	UPROPERTY(Config)
+	float SpatialBiasX;
+
+	UPROPERTY(Config)
+	float SpatialBiasY;
+
+	// Characters closer than this to a viewer replicate at their normal rate
+	UPROPERTY(Config)
+	float ThrottleNearDistance;
+
+	// Characters beyond ThrottleNearDistance replicate every ThrottleMidPeriodScale times their normal period, beyond this every ThrottleFarPeriodScale times.
+	// Must be inside the character net cull distance, it is pulled back to 3/4 of it otherwise
+	UPROPERTY(Config)
+	float ThrottleFarDistance;
+
+	UPROPERTY(Config)
+	int32 ThrottleMidPeriodScale;
+
+	UPROPERTY(Config)
+	int32 ThrottleFarPeriodScale;
+
+private:
+	ESafeZoneClassRepNodeMapping GetMappingPolicy(UClass* Class);
+
+	TClassMap<ESafeZoneClassRepNodeMapping> ClassRepNodePolicies;
+};
+
+/**
+ * Scales the per connection replication period of characters by their distance to the closest viewer of
+ * the connection. Doesn't gather any actors itself, the characters still replicate through the grid node.
+ */
+UCLASS()
+class SAFEZONE_API USafeZoneReplicationGraphNode_DistanceThrottle : public UReplicationGraphNode
+{
+	GENERATED_BODY()
+
+public:
+	USafeZoneReplicationGraphNode_DistanceThrottle();
+
+	virtual void NotifyAddNetworkActor(const FNewReplicatedActorInfo& ActorInfo) override;
+
+	virtual bool NotifyRemoveNetworkActor(const FNewReplicatedActorInfo& ActorInfo, bool bWarnIfNotFound = true) override;
+
+	virtual void NotifyResetAllNetworkActors() override;
+
+	virtual void GatherActorListsForConnection(const FConnectionGatherActorListParameters& Params) override;
+
+	float NearDistance;
+
+	float FarDistance;
+
+	int32 MidPeriodScale;
+
+	int32 FarPeriodScale;
+
+	// A connection refreshes its periods every this many replication frames, spread over the connections
+	uint32 UpdateInterval;
+
+private:
+	FActorRepListRefView Characters;
+};
@@ -0,0 +1,124 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Net/Serialization/FastArraySerializer.h"
+#include "SafeZoneRoster.generated.h"
+
+class ASafeZoneGameState;
+struct FSafeZoneRoster;
+
+// One player of the match as seen by every client
+USTRUCT(BlueprintType)
+struct SAFEZONE_API FSafeZoneRosterEntry : public FFastArraySerializerItem
+{
+	GENERATED_BODY()
+
+	// Registry handle of the player, also its slot in the game state bit arrays
+	UPROPERTY(BlueprintReadOnly, Category = "Roster")
+	int32 PlayerHandle;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Roster")
+	FString DisplayName;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Roster")
+	bool bAlive;
+
+	UPROPERTY(BlueprintReadOnly, Category = "Roster")
+	bool bKnocked;
+
+	// 1 for the first player eliminated, 0 while alive
+	UPROPERTY(BlueprintReadOnly, Category = "Roster")
+	int32 EliminationOrder;
+
+	// Final standing, 1 for the winner. 0 until the player is eliminated or the last one alive
+	UPROPERTY(BlueprintReadOnly, Category = "Roster")
+	int32 Placement;
+
+	FSafeZoneRosterEntry()
+		: PlayerHandle(INDEX_NONE)
+		, bAlive(false)
+		, bKnocked(false)
+		, EliminationOrder(0)
+		, Placement(0)
+	{
+	}
+
+	void PostReplicatedAdd(const FSafeZoneRoster& InArraySerializer);
+
+	void PostReplicatedChange(const FSafeZoneRoster& InArraySerializer);
+
+	void PreReplicatedRemove(const FSafeZoneRoster& InArraySerializer);
+};
+
+/**
+ * Players of the match, replicated as a fast array so only added, changed or removed entries are sent.
+ * Written by the game mode on the server, clients get OnRosterChanged on the game state.
+ */
+USTRUCT()
+struct SAFEZONE_API FSafeZoneRoster : public FFastArraySerializer
+{
+	GENERATED_BODY()
+
+	FSafeZoneRoster()
+		: Owner(nullptr)
+		, NumAlive(0)
+		, NumEliminated(0)
+	{
+	}
+
+	// Adds the player alive, or brings an existing entry back when the player respawns
+	void AddPlayer(int32 PlayerHandle, const FString& DisplayName);
+
+	// Players leaving while alive count as eliminated so later placements stay consistent
+	void RemovePlayer(int32 PlayerHandle);
+
+	void SetKnocked(int32 PlayerHandle, bool bKnocked);
+
+	// Returns the placement of the eliminated player, 0 if it wasn't alive
+	int32 Eliminate(int32 PlayerHandle);
+
+	void Reset();
+
+	const FSafeZoneRosterEntry* Find(int32 PlayerHandle) const;
+
+	const TArray<FSafeZoneRosterEntry>& GetEntries() const
+	{
+		return Entries;
+	}
+
+	// Counted on the server and on clients
+	int32 GetNumAlive() const;
+
+	bool NetDeltaSerialize(FNetDeltaSerializeInfo& DeltaParms)
+	{
+		return FFastArraySerializer::FastArrayDeltaSerialize<FSafeZoneRosterEntry, FSafeZoneRoster>(Entries, DeltaParms, *this);
+	}
+
+	UPROPERTY()
+	TArray<FSafeZoneRosterEntry> Entries;
+
+	UPROPERTY(NotReplicated)
+	ASafeZoneGameState* Owner;
+
+private:
+	int32 FindIndex(int32 PlayerHandle) const;
+
+	// Gives the last player standing first place
+	void UpdateWinner();
+
+	// Server only bookkeeping
+	int32 NumAlive;
+
+	int32 NumEliminated;
+};
+
+template<>
+struct TStructOpsTypeTraits<FSafeZoneRoster> : public TStructOpsTypeTraitsBase2<FSafeZoneRoster>
+{
+	enum
+	{
+		WithNetDeltaSerializer = true,
+	};
+};
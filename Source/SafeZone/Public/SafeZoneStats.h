@@ -0,0 +1,30 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Stats/Stats.h"
+#include "ProfilingDebugging/CsvProfiler.h"
+
+// "stat SafeZone" in game, or the SafeZone category of a csv capture ("csvprofile start" / -csvCaptureFrames=N)
+DECLARE_STATS_GROUP(TEXT("SafeZone"), STATGROUP_SafeZone, STATCAT_Advanced);
+
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Zone Interpolation"), STAT_SafeZone_ZoneInterpolation, STATGROUP_SafeZone, SAFEZONE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Quadrant Update"), STAT_SafeZone_QuadrantUpdate, STATGROUP_SafeZone, SAFEZONE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Target Selection"), STAT_SafeZone_TargetSelection, STATGROUP_SafeZone, SAFEZONE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Membership Pass"), STAT_SafeZone_Membership, STATGROUP_SafeZone, SAFEZONE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Quadrant Occupancy"), STAT_SafeZone_QuadrantOccupancy, STATGROUP_SafeZone, SAFEZONE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Damage Pass"), STAT_SafeZone_DamagePass, STATGROUP_SafeZone, SAFEZONE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("PostGameplayEffectExecute"), STAT_SafeZone_PostGameplayEffectExecute, STATGROUP_SafeZone, SAFEZONE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Health Changed"), STAT_SafeZone_HealthChanged, STATGROUP_SafeZone, SAFEZONE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Outside Tag Changed"), STAT_SafeZone_OutsideTagChanged, STATGROUP_SafeZone, SAFEZONE_API);
+DECLARE_CYCLE_STAT_EXTERN(TEXT("Match Start Init"), STAT_SafeZone_MatchStartInit, STATGROUP_SafeZone, SAFEZONE_API);
+
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Players Outside"), STAT_SafeZone_PlayersOutside, STATGROUP_SafeZone, SAFEZONE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Players In Grace"), STAT_SafeZone_PlayersInGrace, STATGROUP_SafeZone, SAFEZONE_API);
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Damage Applications/s"), STAT_SafeZone_DamageApplicationsPerSecond, STATGROUP_SafeZone, SAFEZONE_API);
+DECLARE_FLOAT_COUNTER_STAT_EXTERN(TEXT("Membership Transitions/s"), STAT_SafeZone_TransitionsPerSecond, STATGROUP_SafeZone, SAFEZONE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Net Characters Throttled Mid"), STAT_SafeZone_NetThrottledMid, STATGROUP_SafeZone, SAFEZONE_API);
+DECLARE_DWORD_COUNTER_STAT_EXTERN(TEXT("Net Characters Throttled Far"), STAT_SafeZone_NetThrottledFar, STATGROUP_SafeZone, SAFEZONE_API);
+
+CSV_DECLARE_CATEGORY_MODULE_EXTERN(SAFEZONE_API, SafeZone);
@@ -0,0 +1,45 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "Subsystems/WorldSubsystem.h"
+#include "SafeZoneSubsystem.generated.h"
+
+class ASafeZoneActor;
+
+DECLARE_MULTICAST_DELEGATE_OneParam(FOnSafeZoneRegistrationChanged, ASafeZoneActor*);
+
+/**
+ * Zones of the world, registered by every ASafeZoneActor on begin play and unregistered on end play,
+ * on the server and on clients. Several zones can be active at once, safe zones and hazard zones
+ * alike, and the game mode resolves membership against all of them in one pass.
+ */
+UCLASS()
+class SAFEZONE_API USafeZoneSubsystem : public UWorldSubsystem
+{
+	GENERATED_BODY()
+
+public:
+	void RegisterZone(ASafeZoneActor* Zone);
+
+	void UnregisterZone(ASafeZoneActor* Zone);
+
+	// Zones in registration order
+	const TArray<ASafeZoneActor*>& GetZones() const
+	{
+		return Zones;
+	}
+
+	// First registered safe zone, its shrink iteration drives the zone damage. Null when there is none
+	UFUNCTION(BlueprintCallable, Category = "Safe Zone")
+	ASafeZoneActor* GetPrimarySafeZone() const;
+
+	FOnSafeZoneRegistrationChanged OnZoneRegistered;
+
+	FOnSafeZoneRegistrationChanged OnZoneUnregistered;
+
+private:
+	UPROPERTY()
+	TArray<ASafeZoneActor*> Zones;
+};
@@ -0,0 +1,39 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayEffectExecutionCalculation.h"
+#include "ZoneDamageGE_ExecutionCalculation.generated.h"
+
+/**
+ * Damage execution for zone and environmental damage. Only reads the Data.Damage SetByCaller magnitude:
+ * no source captures, no tag gathering and no actor resolution, since that damage has no instigator.
+ * Executed by UZoneDamageGameplayEffect, the default zone damage effect.
+ */
+UCLASS()
+class SAFEZONE_API UZoneDamageGE_ExecutionCalculation : public UGameplayEffectExecutionCalculation
+{
+	GENERATED_BODY()
+
+public:
+	UZoneDamageGE_ExecutionCalculation();
+
+	virtual void Execute_Implementation(const FGameplayEffectCustomExecutionParameters& ExecutionParams, OUT FGameplayEffectCustomExecutionOutput& OutExecutionOutput) const override;
+
+protected:
+	// Set by subclasses that capture the target DamageResistance
+	bool bCaptureResistance;
+};
+
+/**
+ * Zone damage scaled down by the DamageResistance attribute of the target.
+ */
+UCLASS()
+class SAFEZONE_API UZoneDamageResistGE_ExecutionCalculation : public UZoneDamageGE_ExecutionCalculation
+{
+	GENERATED_BODY()
+
+public:
+	UZoneDamageResistGE_ExecutionCalculation();
+};
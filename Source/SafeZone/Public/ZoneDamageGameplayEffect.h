@@ -0,0 +1,21 @@
+// Fill out your copyright notice in the Description page of Project Settings.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameplayEffect.h"
+#include "ZoneDamageGameplayEffect.generated.h"
+
+/**
+ * Instant zone damage effect executing UZoneDamageGE_ExecutionCalculation. The damage is the Data.Damage
+ * SetByCaller magnitude, the effect needs no source, so the specs of the damage scheduler can share one
+ * context without instigator. Default zone damage effect of ASafeZoneGameMode.
+ */
+UCLASS()
+class SAFEZONE_API UZoneDamageGameplayEffect : public UGameplayEffect
+{
+	GENERATED_BODY()
+
+public:
+	UZoneDamageGameplayEffect();
+};
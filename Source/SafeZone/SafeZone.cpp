@@ -1,6 +1,18 @@
-// Copyright Epic Games, Inc. All Rights Reserved.
-
-#include "SafeZone.h"
-#include "Modules/ModuleManager.h"
-
-IMPLEMENT_PRIMARY_GAME_MODULE( FDefaultGameModuleImpl, SafeZone, "SafeZone" );
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#include "SafeZone.h"
+#include "Modules/ModuleManager.h"
+#include "SafeZoneGameplayTags.h"
+
+class FSafeZoneModule : public FDefaultGameModuleImpl
+{
+public:
+	virtual void StartupModule() override
+	{
+		// Before the tags manager stops accepting native tags at the end of engine init, in case nothing
+		// read the tags yet
+		FSafeZoneGameplayTags::InitializeNativeTags();
+	}
+};
+
+IMPLEMENT_PRIMARY_GAME_MODULE( FSafeZoneModule, SafeZone, "SafeZone" );
@@ -1,17 +1,17 @@
-// Copyright Epic Games, Inc. All Rights Reserved.
-
-#pragma once
-
-#include "CoreMinimal.h"
-#include "GameFramework/GameModeBase.h"
-#include "SafeZoneGameModeBase.generated.h"
-
-/**
- * 
- */
-UCLASS()
-class SAFEZONE_API ASafeZoneGameModeBase : public AGameModeBase
-{
-	GENERATED_BODY()
-	
-};
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+#pragma once
+
+#include "CoreMinimal.h"
+#include "GameFramework/GameModeBase.h"
+#include "SafeZoneGameModeBase.generated.h"
+
+/**
+ * 
+ */
+UCLASS()
+class SAFEZONE_API ASafeZoneGameModeBase : public AGameModeBase
+{
+	GENERATED_BODY()
+	
+};
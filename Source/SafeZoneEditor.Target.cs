@@ -1,14 +1,18 @@
-// Copyright Epic Games, Inc. All Rights Reserved.
-
-using UnrealBuildTool;
-using System.Collections.Generic;
-
-public class SafeZoneEditorTarget : TargetRules
-{
-	public SafeZoneEditorTarget( TargetInfo Target) : base(Target)
-	{
-		Type = TargetType.Editor;
-		DefaultBuildSettings = BuildSettingsVersion.V2;
-		ExtraModuleNames.AddRange( new string[] { "SafeZone" } );
-	}
-}
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+using System.Collections.Generic;
+
+public class SafeZoneEditorTarget : TargetRules
+{
+	public SafeZoneEditorTarget( TargetInfo Target) : base(Target)
+	{
+		Type = TargetType.Editor;
+		DefaultBuildSettings = BuildSettingsVersion.V2;
+
+		// Push based properties fall back to the regular compare. Dirty tracking needs a source built engine:
+		// bWithPushModel = true;
+		// BuildEnvironment = TargetBuildEnvironment.Unique;
+		ExtraModuleNames.AddRange( new string[] { "SafeZone" } );
+	}
+}
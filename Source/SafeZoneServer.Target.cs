@@ -0,0 +1,18 @@
+// Copyright Epic Games, Inc. All Rights Reserved.
+
+using UnrealBuildTool;
+using System.Collections.Generic;
+
+public class SafeZoneServerTarget : TargetRules
+{
+	public SafeZoneServerTarget( TargetInfo Target) : base(Target)
+	{
+		Type = TargetType.Server;
+		DefaultBuildSettings = BuildSettingsVersion.V2;
+
+		// Push based properties fall back to the regular compare. Dirty tracking needs a source built engine:
+		// bWithPushModel = true;
+		// BuildEnvironment = TargetBuildEnvironment.Unique;
+		ExtraModuleNames.AddRange( new string[] { "SafeZone" } );
+	}
+}